@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/**
+	@struct AnyAggregateField
+	@brief  Converts to any type, used to count an aggregate's fields by brace-initializing it; never actually called
+**/
+struct AnyAggregateField
+{
+	template<typename T>
+	constexpr operator T() const noexcept;
+};
+
+/**
+	@brief  Number of fields of an aggregate type
+
+	Tries to brace-initialize T with one more AnyAggregateField until it fails. Fields that are arrays or aggregates
+	themselves are miscounted (brace elision lets them take several initializers), so only flat aggregates are supported.
+	@tparam T - aggregate type
+	@retval size_t number of fields
+**/
+template<typename T, typename... TFields>
+constexpr std::size_t aggregateFieldCount() noexcept
+{
+	if constexpr (requires { T{ TFields{}..., AnyAggregateField{} }; })
+	{
+		return aggregateFieldCount<T, TFields..., AnyAggregateField>();
+	}
+	else
+	{
+		return sizeof...(TFields);
+	}
+}
+
+/**
+	@brief  Tuple of references to the fields of an aggregate, in declaration order
+
+	Supports aggregates of up to 8 fields.
+	@param  value - aggregate to reference
+	@retval std::tuple<TField&...> references to value's fields
+**/
+template<typename T>
+constexpr auto tieFields(T& value) noexcept
+{
+	constexpr auto count = aggregateFieldCount<std::remove_const_t<T>>();
+	static_assert(count >= 1 && count <= 8, "tieFields supports aggregates with 1 to 8 fields");
+
+	if constexpr (count == 1)
+	{
+		auto& [f0] = value;
+		return std::tie(f0);
+	}
+	else if constexpr (count == 2)
+	{
+		auto& [f0, f1] = value;
+		return std::tie(f0, f1);
+	}
+	else if constexpr (count == 3)
+	{
+		auto& [f0, f1, f2] = value;
+		return std::tie(f0, f1, f2);
+	}
+	else if constexpr (count == 4)
+	{
+		auto& [f0, f1, f2, f3] = value;
+		return std::tie(f0, f1, f2, f3);
+	}
+	else if constexpr (count == 5)
+	{
+		auto& [f0, f1, f2, f3, f4] = value;
+		return std::tie(f0, f1, f2, f3, f4);
+	}
+	else if constexpr (count == 6)
+	{
+		auto& [f0, f1, f2, f3, f4, f5] = value;
+		return std::tie(f0, f1, f2, f3, f4, f5);
+	}
+	else if constexpr (count == 7)
+	{
+		auto& [f0, f1, f2, f3, f4, f5, f6] = value;
+		return std::tie(f0, f1, f2, f3, f4, f5, f6);
+	}
+	else
+	{
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7] = value;
+		return std::tie(f0, f1, f2, f3, f4, f5, f6, f7);
+	}
+}
+
+/**
+	@brief Type of the I-th field of aggregate T
+**/
+template<typename T, std::size_t I>
+using AggregateField = std::remove_reference_t<std::tuple_element_t<I, decltype(tieFields(std::declval<T&>()))>>;
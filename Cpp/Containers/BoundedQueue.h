@@ -0,0 +1,387 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include "LinkedList.h"
+
+/**
+	@enum  OverflowPolicy
+	@brief What a BoundedQueue does with a value that would exceed it's budget
+**/
+enum class OverflowPolicy
+{
+	// the value is rejected, push_back() returns false
+	Fail,
+	// push_back() waits until consumers have made room or the queue is closed
+	Block,
+	// the oldest values are dropped until the new value fits
+	DropOldest
+};
+
+/**
+	@struct QueueBudget
+	@brief  Limits of a BoundedQueue, 0 means no limit
+**/
+struct QueueBudget
+{
+	std::size_t maxValues = 0;
+	std::size_t maxBytes = 0;
+};
+
+/**
+	@struct QueueNodeBytes
+	@brief  Default byte cost of a queued value: the LinkedList node holding it
+**/
+template<typename TValue>
+struct QueueNodeBytes
+{
+	std::size_t operator()(const TValue&) const noexcept
+	{
+		return sizeof(LinkedListNode<TValue>);
+	}
+};
+
+/**
+
+	@class   BoundedQueue
+	@brief   Thread-safe FIFO queue on a LinkedList with a budget in values and/or bytes
+
+	@details ~ A queue fed faster than it is drained grows until the process runs out of memory. BoundedQueue keeps a running
+			   count of values and bytes and applies an OverflowPolicy when a push would exceed the budget: fail fast, block the
+			   producer until consumers make room, or drop the oldest values. Under budget a push costs one uncontended lock and
+			   two comparisons more than LinkedList::push_back().
+			   Bytes are measured with TBytes, by default the size of the list node; pass a functor that adds heap memory owned
+			   by the value (e.g. a string's capacity) to budget that too. The admission check measures the value passed in,
+			   while the running count is charged and refunded with the cost of the queued copy, so it never drifts.
+			   A value that does not fit even into an empty queue is always rejected. dropped(), blocked() and rejected()
+			   count overload events since construction.
+			   close() wakes blocked producers and makes further pushes fail, values already queued can still be popped.
+	@tparam  TValue - type of queue's values
+	@tparam  TBytes - functor returning the bytes a queued value costs
+
+**/
+template<typename TValue, typename TBytes = QueueNodeBytes<TValue>>
+class BoundedQueue
+{
+public:
+	/**
+		@brief Construct an empty queue
+		@param budget - maximum values and bytes held at once
+		@param policy - what to do with a value that would exceed the budget
+		@param bytes  - functor measuring a value's cost in bytes
+	**/
+	explicit BoundedQueue(QueueBudget budget, OverflowPolicy policy = OverflowPolicy::Fail, TBytes bytes = TBytes());
+
+	BoundedQueue(const BoundedQueue&) = delete;
+	BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+	using value_type = TValue;
+	using size_type = std::size_t;
+
+	/**
+		@brief  Returns number of values in the queue
+
+		Performs in O(1) constant time
+	**/
+	size_type size() const;
+
+	/**
+		@brief  Determines if the queue is empty
+
+		Performs in O(1) constant time
+	**/
+	bool empty() const;
+
+	/**
+		@brief  Bytes currently charged against the budget
+
+		Performs in O(1) constant time
+	**/
+	std::size_t bytes() const;
+
+	/**
+		@brief  Add a value to the back of the queue, applying the overflow policy if it does not fit
+
+		Performs in O(1) constant time under budget; OverflowPolicy::DropOldest takes O(k) for k dropped values
+		@param  val - value to add
+		@retval bool true if the value was queued; false if it was rejected (OverflowPolicy::Fail, a value larger
+				than the whole budget, or a closed queue)
+	**/
+	bool push_back(const TValue& val);
+	bool push_back(TValue&& val);
+
+	/**
+		@brief  Removes the oldest value of the queue and returns it
+
+		Performs in O(1) constant time
+		@exception std::runtime_error if queue is empty
+	**/
+	value_type pop_front();
+
+	/**
+		@brief  Removes the oldest value of the queue, if there is one
+
+		Performs in O(1) constant time
+		@param  out - receives the removed value
+		@retval bool true if a value was removed, false if the queue is empty
+	**/
+	bool try_pop_front(TValue& out);
+
+	/**
+		@brief Removes all values of the queue and wakes blocked producers
+	**/
+	void clear();
+
+	/**
+		@brief Stop accepting values; blocked and later push_back() calls return false
+	**/
+	void close();
+
+	/**
+		@brief  Number of values dropped by OverflowPolicy::DropOldest
+	**/
+	std::size_t dropped() const;
+
+	/**
+		@brief  Number of push_back() calls that had to wait under OverflowPolicy::Block
+	**/
+	std::size_t blocked() const;
+
+	/**
+		@brief  Number of values push_back() rejected
+	**/
+	std::size_t rejected() const;
+
+	/**
+		@brief Get string representation of the queue's values suitable for display
+	**/
+	std::string toString() const;
+
+private:
+	const QueueBudget budget;
+	const OverflowPolicy policy;
+	TBytes measure;
+
+	mutable std::mutex mutex;
+	// signalled when values leave the queue or it is closed; producers may wait for different amounts of room, so all are woken
+	std::condition_variable space;
+
+	LinkedList<TValue> list;
+	std::size_t byteCount;
+	bool closed;
+	// producers blocked in push_back(), consumers only signal when there are any
+	std::size_t waiting;
+
+	std::size_t droppedCount;
+	std::size_t blockedCount;
+	std::size_t rejectedCount;
+
+	// Determines if a value costing valueBytes fits next to the queued values
+	bool fits(std::size_t valueBytes) const noexcept;
+
+	// Apply the overflow policy until val fits and queue it, the caller holds lock
+	template<typename TArg>
+	bool push(TArg&& val, std::unique_lock<std::mutex>& lock);
+
+	// Remove the oldest value, the caller holds the mutex and the queue is not empty
+	TValue take();
+};
+
+template<typename TValue, typename TBytes>
+inline BoundedQueue<TValue, TBytes>::BoundedQueue(QueueBudget budget, OverflowPolicy policy, TBytes bytes)
+	: budget(budget)
+	, policy(policy)
+	, measure(std::move(bytes))
+	, mutex()
+	, space()
+	, list()
+	, byteCount(0)
+	, closed(false)
+	, waiting(0)
+	, droppedCount(0)
+	, blockedCount(0)
+	, rejectedCount(0)
+{}
+
+template<typename TValue, typename TBytes>
+inline std::size_t BoundedQueue<TValue, TBytes>::size() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return list.size();
+}
+
+template<typename TValue, typename TBytes>
+inline bool BoundedQueue<TValue, TBytes>::empty() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return list.empty();
+}
+
+template<typename TValue, typename TBytes>
+inline std::size_t BoundedQueue<TValue, TBytes>::bytes() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return byteCount;
+}
+
+template<typename TValue, typename TBytes>
+inline bool BoundedQueue<TValue, TBytes>::push_back(const TValue& val)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	return push(val, lock);
+}
+
+template<typename TValue, typename TBytes>
+inline bool BoundedQueue<TValue, TBytes>::push_back(TValue&& val)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	return push(std::move(val), lock);
+}
+
+template<typename TValue, typename TBytes>
+inline TValue BoundedQueue<TValue, TBytes>::pop_front()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	if (list.empty()) throw std::runtime_error("cannot remove from empty list");
+	auto val = take();
+	auto wake = waiting > 0;
+	lock.unlock();
+	if (wake)
+	{
+		space.notify_all();
+	}
+	return val;
+}
+
+template<typename TValue, typename TBytes>
+inline bool BoundedQueue<TValue, TBytes>::try_pop_front(TValue& out)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	if (list.empty())
+	{
+		return false;
+	}
+	out = take();
+	auto wake = waiting > 0;
+	lock.unlock();
+	if (wake)
+	{
+		space.notify_all();
+	}
+	return true;
+}
+
+template<typename TValue, typename TBytes>
+inline void BoundedQueue<TValue, TBytes>::clear()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		list.clear();
+		byteCount = 0;
+	}
+	space.notify_all();
+}
+
+template<typename TValue, typename TBytes>
+inline void BoundedQueue<TValue, TBytes>::close()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		closed = true;
+	}
+	space.notify_all();
+}
+
+template<typename TValue, typename TBytes>
+inline std::size_t BoundedQueue<TValue, TBytes>::dropped() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return droppedCount;
+}
+
+template<typename TValue, typename TBytes>
+inline std::size_t BoundedQueue<TValue, TBytes>::blocked() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return blockedCount;
+}
+
+template<typename TValue, typename TBytes>
+inline std::size_t BoundedQueue<TValue, TBytes>::rejected() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return rejectedCount;
+}
+
+template<typename TValue, typename TBytes>
+inline std::string BoundedQueue<TValue, TBytes>::toString() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return list.toString();
+}
+
+template<typename TValue, typename TBytes>
+inline bool BoundedQueue<TValue, TBytes>::fits(std::size_t valueBytes) const noexcept
+{
+	return (budget.maxValues == 0 || list.size() < budget.maxValues)
+		&& (budget.maxBytes == 0 || byteCount + valueBytes <= budget.maxBytes);
+}
+
+template<typename TValue, typename TBytes>
+template<typename TArg>
+inline bool BoundedQueue<TValue, TBytes>::push(TArg&& val, std::unique_lock<std::mutex>& lock)
+{
+	auto valueBytes = measure(val);
+	if (closed || (budget.maxBytes != 0 && valueBytes > budget.maxBytes))
+	{
+		rejectedCount++;
+		return false;
+	}
+
+	if (!fits(valueBytes))
+	{
+		switch (policy)
+		{
+		case OverflowPolicy::Fail:
+			rejectedCount++;
+			return false;
+		case OverflowPolicy::Block:
+			blockedCount++;
+			waiting++;
+			space.wait(lock, [&] { return closed || fits(valueBytes); });
+			waiting--;
+			if (closed)
+			{
+				rejectedCount++;
+				return false;
+			}
+			break;
+		case OverflowPolicy::DropOldest:
+			while (!list.empty() && !fits(valueBytes))
+			{
+				take();
+				droppedCount++;
+			}
+			break;
+		}
+	}
+
+	list.push_back(std::forward<TArg>(val));
+	// charge the stored copy, the same figure take() refunds; it can differ from the argument's (e.g. a smaller capacity)
+	byteCount += measure(list.back());
+	return true;
+}
+
+template<typename TValue, typename TBytes>
+inline TValue BoundedQueue<TValue, TBytes>::take()
+{
+	// refund what push() charged: the stored value, not the copy pop_front() returns
+	auto valueBytes = measure(list.front());
+	auto val = list.pop_front();
+	byteCount -= valueBytes;
+	return val;
+}
@@ -0,0 +1,421 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "HashMix.h"
+#include "NodePool.h"
+
+/**
+
+	@class   ChainedHashMap
+	@brief   Hash map with separate chaining, chain nodes come from a shared NodePool
+
+	@details ~ Each bucket is a singly-linked chain of nodes. All nodes of the map are allocated from one NodePool,
+			   so inserts cost an allocation only once per NodePool block and erased nodes are recycled.
+			   Every node caches its key's hash, so rehashing relinks nodes without rehashing keys or
+			   allocating, and probes compare hashes before comparing keys.
+			   Shares it's interface with FlatHashMap, see HashMap.h for choosing between them.
+	@tparam  TKey   - type of keys
+	@tparam  TValue - type of mapped values
+	@tparam  THash  - hash function object for TKey
+	@tparam  TEqual - equality function object for TKey
+
+**/
+template<typename TKey, typename TValue, typename THash = std::hash<TKey>, typename TEqual = std::equal_to<TKey>>
+class ChainedHashMap
+{
+public:
+	/**
+		@brief Construct an empty map, no memory is allocated until the first insert
+	**/
+	ChainedHashMap() noexcept;
+	~ChainedHashMap();
+
+	ChainedHashMap(const ChainedHashMap&) = delete;
+	ChainedHashMap& operator=(const ChainedHashMap&) = delete;
+
+	ChainedHashMap(ChainedHashMap&& other) noexcept;
+	ChainedHashMap& operator=(ChainedHashMap&& other) noexcept;
+
+	using key_type = TKey;
+	using mapped_type = TValue;
+	using size_type = std::size_t;
+
+	/**
+		@brief  Returns number of keys in the map
+
+		Performs in O(1) constant time
+	**/
+	size_type size() const noexcept;
+
+	/**
+		@brief  Determines if the map is empty
+
+		Performs in O(1) constant time
+	**/
+	bool empty() const noexcept;
+
+	/**
+		@brief  Add a key and it's value if the key is not in the map yet
+
+		Performs in O(1) average constant time
+		@param  key   - key to add
+		@param  value - value to map the key to
+		@retval bool true if the key was added, false if it was already present (it's value is left unchanged)
+	**/
+	bool insert(const TKey& key, const TValue& value);
+
+	/**
+		@brief  Access the value mapped to a key, adding a default constructed value if the key is not in the map
+
+		Performs in O(1) average constant time
+	**/
+	TValue& operator[](const TKey& key);
+
+	/**
+		@brief  Access the value mapped to a key
+
+		Performs in O(1) average constant time
+		@exception std::runtime_error if the key is not in the map
+	**/
+	TValue& at(const TKey& key);
+	const TValue& at(const TKey& key) const;
+
+	/**
+		@brief  Look up the value mapped to a key
+
+		Performs in O(1) average constant time
+		@retval TValue* pointer to the mapped value, or nullptr if the key is not in the map
+	**/
+	TValue* find(const TKey& key);
+	const TValue* find(const TKey& key) const;
+
+	/**
+		@brief  Determines if the map contains a key
+
+		Performs in O(1) average constant time
+	**/
+	bool contains(const TKey& key) const;
+
+	/**
+		@brief  Remove a key and it's value
+
+		Performs in O(1) average constant time
+		@retval bool true if the key was removed, false if it was not in the map
+	**/
+	bool erase(const TKey& key);
+
+	/**
+		@brief Remove all keys, bucket and node memory is kept for reuse
+	**/
+	void clear();
+
+	/**
+		@brief Prepare the map to hold a number of keys without rehashing
+		@param count - number of keys
+	**/
+	void reserve(size_type count);
+
+	/**
+		@brief Call a function with every key and value in the map, in unspecified order
+		@param func - callable as func(const TKey&, TValue&)
+	**/
+	template<typename TFunc>
+	void forEach(TFunc&& func);
+
+	/**
+		@brief  Bytes of heap memory held by the map
+	**/
+	std::size_t memoryUsage() const noexcept;
+
+private:
+	// forward declaration (implementation below)
+	struct Node;
+
+	std::vector<Node*> buckets;
+	NodePool<Node> pool;
+
+	size_type count;
+
+	THash hasher;
+	TEqual equal;
+
+	// Hash a key, mixed so the low bits are usable as bucket index
+	std::uint64_t hashOf(const TKey& key) const;
+
+	// Find the node holding a key, or nullptr
+	Node* findNode(const TKey& key, std::uint64_t hash) const;
+
+	// Add a node for a key known to be absent
+	Node* insertNode(const TKey& key, const TValue& value, std::uint64_t hash);
+
+	// Resize the bucket array (power of two) and relink all nodes into it
+	void rehash(size_type bucketCount);
+};
+
+/**
+	@struct Node
+	@brief  Represents a key and it's value in a bucket chain
+**/
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+struct ChainedHashMap<TKey, TValue, THash, TEqual>::Node
+{
+	Node(const TKey& key, const TValue& value, std::uint64_t hash, Node* next)
+		: next(next)
+		, hash(hash)
+		, key(key)
+		, value(value)
+	{}
+
+	Node* next;
+	std::uint64_t hash;
+	TKey key;
+	TValue value;
+};
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline ChainedHashMap<TKey, TValue, THash, TEqual>::ChainedHashMap() noexcept
+	: buckets()
+	, pool()
+	, count(0)
+{}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline ChainedHashMap<TKey, TValue, THash, TEqual>::~ChainedHashMap()
+{
+	clear();
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline ChainedHashMap<TKey, TValue, THash, TEqual>::ChainedHashMap(ChainedHashMap&& other) noexcept
+	: buckets(std::move(other.buckets))
+	, pool(std::move(other.pool))
+	, count(std::exchange(other.count, 0))
+	, hasher(std::move(other.hasher))
+	, equal(std::move(other.equal))
+{
+	other.buckets.clear();
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline ChainedHashMap<TKey, TValue, THash, TEqual>& ChainedHashMap<TKey, TValue, THash, TEqual>::operator=(ChainedHashMap&& other) noexcept
+{
+	if (this != &other)
+	{
+		clear();
+		buckets = std::move(other.buckets);
+		pool = std::move(other.pool);
+		count = std::exchange(other.count, 0);
+		hasher = std::move(other.hasher);
+		equal = std::move(other.equal);
+		other.buckets.clear();
+	}
+	return *this;
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline std::size_t ChainedHashMap<TKey, TValue, THash, TEqual>::size() const noexcept
+{
+	return count;
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline bool ChainedHashMap<TKey, TValue, THash, TEqual>::empty() const noexcept
+{
+	return count == 0;
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline bool ChainedHashMap<TKey, TValue, THash, TEqual>::insert(const TKey& key, const TValue& value)
+{
+	auto hash = hashOf(key);
+	if (findNode(key, hash) != nullptr)
+	{
+		return false;
+	}
+	insertNode(key, value, hash);
+	return true;
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline TValue& ChainedHashMap<TKey, TValue, THash, TEqual>::operator[](const TKey& key)
+{
+	auto hash = hashOf(key);
+	auto node = findNode(key, hash);
+	if (node == nullptr)
+	{
+		node = insertNode(key, TValue(), hash);
+	}
+	return node->value;
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline TValue& ChainedHashMap<TKey, TValue, THash, TEqual>::at(const TKey& key)
+{
+	auto node = findNode(key, hashOf(key));
+	if (node == nullptr) throw std::runtime_error("key not found");
+	return node->value;
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline const TValue& ChainedHashMap<TKey, TValue, THash, TEqual>::at(const TKey& key) const
+{
+	auto node = findNode(key, hashOf(key));
+	if (node == nullptr) throw std::runtime_error("key not found");
+	return node->value;
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline TValue* ChainedHashMap<TKey, TValue, THash, TEqual>::find(const TKey& key)
+{
+	auto node = findNode(key, hashOf(key));
+	return node != nullptr ? &node->value : nullptr;
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline const TValue* ChainedHashMap<TKey, TValue, THash, TEqual>::find(const TKey& key) const
+{
+	auto node = findNode(key, hashOf(key));
+	return node != nullptr ? &node->value : nullptr;
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline bool ChainedHashMap<TKey, TValue, THash, TEqual>::contains(const TKey& key) const
+{
+	return findNode(key, hashOf(key)) != nullptr;
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline bool ChainedHashMap<TKey, TValue, THash, TEqual>::erase(const TKey& key)
+{
+	if (count == 0)
+	{
+		return false;
+	}
+
+	auto hash = hashOf(key);
+	// link = the pointer that points at the current node, so unlinking needs no prev pointer
+	auto link = &buckets[hash & (buckets.size() - 1)];
+	while (*link != nullptr)
+	{
+		auto node = *link;
+		if (node->hash == hash && equal(node->key, key))
+		{
+			*link = node->next;
+			pool.destroy(node);
+			count--;
+			return true;
+		}
+		link = &node->next;
+	}
+	return false;
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline void ChainedHashMap<TKey, TValue, THash, TEqual>::clear()
+{
+	for (auto& bucket : buckets)
+	{
+		while (bucket != nullptr)
+		{
+			auto next = bucket->next;
+			pool.destroy(bucket);
+			bucket = next;
+		}
+	}
+	count = 0;
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline void ChainedHashMap<TKey, TValue, THash, TEqual>::reserve(size_type count)
+{
+	size_type bucketCount = 16;
+	while (bucketCount < count)
+	{
+		bucketCount *= 2;
+	}
+	if (bucketCount > buckets.size())
+	{
+		rehash(bucketCount);
+	}
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+template<typename TFunc>
+inline void ChainedHashMap<TKey, TValue, THash, TEqual>::forEach(TFunc&& func)
+{
+	for (auto bucket : buckets)
+	{
+		for (auto node = bucket; node != nullptr; node = node->next)
+		{
+			func(static_cast<const TKey&>(node->key), node->value);
+		}
+	}
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline std::size_t ChainedHashMap<TKey, TValue, THash, TEqual>::memoryUsage() const noexcept
+{
+	return buckets.capacity() * sizeof(Node*) + pool.memoryUsage();
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline std::uint64_t ChainedHashMap<TKey, TValue, THash, TEqual>::hashOf(const TKey& key) const
+{
+	return mixHash(hasher(key));
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline typename ChainedHashMap<TKey, TValue, THash, TEqual>::Node* ChainedHashMap<TKey, TValue, THash, TEqual>::findNode(const TKey& key, std::uint64_t hash) const
+{
+	if (count == 0)
+	{
+		return nullptr;
+	}
+
+	for (auto node = buckets[hash & (buckets.size() - 1)]; node != nullptr; node = node->next)
+	{
+		if (node->hash == hash && equal(node->key, key))
+		{
+			return node;
+		}
+	}
+	return nullptr;
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline typename ChainedHashMap<TKey, TValue, THash, TEqual>::Node* ChainedHashMap<TKey, TValue, THash, TEqual>::insertNode(const TKey& key, const TValue& value, std::uint64_t hash)
+{
+	// keep the load factor at or below 1
+	if (count + 1 > buckets.size())
+	{
+		rehash(buckets.empty() ? 16 : buckets.size() * 2);
+	}
+
+	auto& bucket = buckets[hash & (buckets.size() - 1)];
+	bucket = pool.create(key, value, hash, bucket);
+	count++;
+	return bucket;
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline void ChainedHashMap<TKey, TValue, THash, TEqual>::rehash(size_type bucketCount)
+{
+	std::vector<Node*> resized(bucketCount, nullptr);
+	for (auto bucket : buckets)
+	{
+		while (bucket != nullptr)
+		{
+			auto next = bucket->next;
+			auto& target = resized[bucket->hash & (bucketCount - 1)];
+			bucket->next = target;
+			target = bucket;
+			bucket = next;
+		}
+	}
+	buckets.swap(resized);
+}
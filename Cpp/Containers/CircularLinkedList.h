@@ -0,0 +1,577 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include "NodeCache.h"
+
+/**
+
+	@class   CircularLinkedList
+	@brief   Doubly-linked list arranged as a ring through a sentinel node owned by the list
+
+	@details ~ LinkedList ends in nullptr on both sides, so every insertion and removal checks for missing neighbours and
+			   patches head or tail. Here the list object holds a sentinel link that sits between the last and the first node,
+			   so every node always has both neighbours: linking and unlinking are four unconditional pointer stores,
+			   push_front()/push_back() are insertions after/before the sentinel, and an empty list is a sentinel linked to itself.
+			   end() is the sentinel, so --end() is the last value. Nodes come from the NodeCache shared with LinkedList.
+			   Because nodes point at the sentinel inside the list object, moving a list re-points the first and last node.
+	@tparam  TValue - type of list's values
+
+**/
+template<typename TValue>
+class CircularLinkedList
+{
+public:
+	using value_type = TValue;
+	using reference = value_type&;
+	using const_reference = const value_type&;
+	using size_type = std::size_t;
+
+	class iterator;
+
+	/**
+		@brief Construct an empty list
+	**/
+	CircularLinkedList() noexcept;
+	~CircularLinkedList();
+
+	/**
+		@brief Construct a list holding copies of another list's values
+
+		Performs in O(n) linear time, where n = the number of values in the other list
+	**/
+	CircularLinkedList(const CircularLinkedList& other);
+
+	/**
+		@brief Construct a list taking over another list's nodes, the other list is left empty
+
+		Performs in O(1) constant time
+	**/
+	CircularLinkedList(CircularLinkedList&& other) noexcept;
+
+	CircularLinkedList& operator=(const CircularLinkedList& other);
+	CircularLinkedList& operator=(CircularLinkedList&& other) noexcept;
+
+	/**
+		@brief  Returns size of the list
+
+		Performs in O(1) constant time
+	**/
+	size_type size() const noexcept;
+
+	/**
+		@brief  Determines if the list is empty
+
+		Performs in O(1) constant time
+	**/
+	bool empty() const noexcept;
+
+	/**
+		@brief Add an element to the front of the list
+
+		Performs in O(1) constant time
+		@param val - value to add
+	**/
+	void push_front(const TValue& val);
+	void push_front(TValue&& val);
+
+	/**
+		@brief Add an element to the end of the list
+
+		Performs in O(1) constant time
+		@param val - value to add
+	**/
+	void push_back(const TValue& val);
+	void push_back(TValue&& val);
+
+	/**
+		@brief  Return the value at the beginning of the list
+		@exception std::runtime_error if list is empty
+	**/
+	reference front();
+	const_reference front() const;
+
+	/**
+		@brief  Return the value at the end of the list
+		@exception std::runtime_error if list is empty
+	**/
+	reference back();
+	const_reference back() const;
+
+	/**
+		@brief  Removes the value at the beginning of the list and returns it
+
+		Performs in O(1) constant time
+		@exception std::runtime_error if list is empty
+	**/
+	value_type pop_front();
+
+	/**
+		@brief  Removes the value at the end of the list and returns it
+
+		Performs in O(1) constant time
+		@exception std::runtime_error if list is empty
+	**/
+	value_type pop_back();
+
+	/**
+		@brief  Add a value BEFORE the given position
+
+		Performs in O(1) constant time
+		@param  pos - iterator into this list, end() appends
+		@param  val - value to add
+		@retval iterator pointing at the added value
+	**/
+	iterator insert(iterator pos, const TValue& val);
+
+	/**
+		@brief  Removes the value the iterator points at
+
+		Performs in O(1) constant time
+		@param  pos - valid, dereferenceable iterator into this list
+		@retval iterator pointing at the value following the removed one
+	**/
+	iterator erase(iterator pos);
+
+	/**
+		@brief  Search the list for the first node holding a value
+
+		Performs in O(n) linear time, where n = the number of values in the list
+		@retval iterator pointing at the found value, or end() if the value is not in the list
+	**/
+	iterator find(const TValue& val);
+
+	/**
+		@brief  Determines if the list contains a value
+
+		Performs in O(n) linear time, where n = the number of values in the list
+	**/
+	bool contains(const TValue& val) const;
+
+	/**
+		@brief Removes all values of the list
+
+		Performs in O(n) linear time, where n = the number of values in the list
+	**/
+	void clear() noexcept;
+
+	iterator begin() noexcept;
+	iterator end() noexcept;
+
+	/**
+		@brief Get string representation of the list's values suitable for display
+	**/
+	std::string toString() const;
+
+private:
+	struct Link
+	{
+		Link* next;
+		Link* prev;
+	};
+
+	struct Node : Link
+	{
+		TValue value;
+
+		template<typename TArg>
+		explicit Node(TArg&& val)
+			: Link{ nullptr, nullptr }
+			, value(std::forward<TArg>(val))
+		{}
+	};
+
+	// sits between the last and the first node, never holds a value
+	Link sentinel;
+	size_type count;
+
+	static Node* toNode(Link* link) noexcept;
+	static const Node* toNode(const Link* link) noexcept;
+
+	// Allocate a node holding val and link it BEFORE the given link
+	template<typename TArg>
+	Link* insertBefore(Link* link, TArg&& val);
+	// Unlink a node, move it's value out and free the node
+	TValue remove(Link* link);
+	// Unlink and free a node without looking at it's value
+	void destroy(Link* link) noexcept;
+
+	// Take over another list's ring, this list must be empty
+	void take(CircularLinkedList& other) noexcept;
+};
+
+/**
+	@class  CircularLinkedList::iterator
+	@brief  Bidirectional iterator over a CircularLinkedList, end() is the sentinel
+**/
+template<typename TValue>
+class CircularLinkedList<TValue>::iterator
+{
+public:
+	using iterator_category = std::bidirectional_iterator_tag;
+	using value_type = TValue;
+	using difference_type = std::ptrdiff_t;
+	using pointer = value_type*;
+	using reference = value_type&;
+
+	constexpr iterator() noexcept
+		: current(nullptr)
+	{}
+
+	reference operator*() const noexcept
+	{
+		return toNode(current)->value;
+	}
+
+	pointer operator->() const noexcept
+	{
+		return &toNode(current)->value;
+	}
+
+	iterator& operator++() noexcept
+	{
+		current = current->next;
+		return *this;
+	}
+
+	iterator operator++(int) noexcept
+	{
+		auto it = *this;
+		++*this;
+		return it;
+	}
+
+	iterator& operator--() noexcept
+	{
+		current = current->prev;
+		return *this;
+	}
+
+	iterator operator--(int) noexcept
+	{
+		auto it = *this;
+		--*this;
+		return it;
+	}
+
+	bool operator==(const iterator& other) const noexcept
+	{
+		return current == other.current;
+	}
+
+	bool operator!=(const iterator& other) const noexcept
+	{
+		return !(*this == other);
+	}
+
+private:
+	Link* current;
+
+	explicit constexpr iterator(Link* current) noexcept
+		: current(current)
+	{}
+
+	friend class CircularLinkedList<TValue>;
+};
+
+template<typename TValue>
+inline CircularLinkedList<TValue>::CircularLinkedList() noexcept
+	: sentinel{ &sentinel, &sentinel }
+	, count(0)
+{}
+
+template<typename TValue>
+inline CircularLinkedList<TValue>::~CircularLinkedList()
+{
+	clear();
+}
+
+template<typename TValue>
+inline CircularLinkedList<TValue>::CircularLinkedList(const CircularLinkedList& other)
+	: CircularLinkedList()
+{
+	try
+	{
+		for (auto n = other.sentinel.next; n != &other.sentinel; n = n->next)
+		{
+			insertBefore(&sentinel, toNode(n)->value);
+		}
+	}
+	catch (...)
+	{
+		clear();
+		throw;
+	}
+}
+
+template<typename TValue>
+inline CircularLinkedList<TValue>::CircularLinkedList(CircularLinkedList&& other) noexcept
+	: CircularLinkedList()
+{
+	take(other);
+}
+
+template<typename TValue>
+inline CircularLinkedList<TValue>& CircularLinkedList<TValue>::operator=(const CircularLinkedList& other)
+{
+	if (this != &other)
+	{
+		CircularLinkedList copy(other);
+		clear();
+		take(copy);
+	}
+	return *this;
+}
+
+template<typename TValue>
+inline CircularLinkedList<TValue>& CircularLinkedList<TValue>::operator=(CircularLinkedList&& other) noexcept
+{
+	if (this != &other)
+	{
+		clear();
+		take(other);
+	}
+	return *this;
+}
+
+template<typename TValue>
+inline std::size_t CircularLinkedList<TValue>::size() const noexcept
+{
+	return count;
+}
+
+template<typename TValue>
+inline bool CircularLinkedList<TValue>::empty() const noexcept
+{
+	return sentinel.next == &sentinel;
+}
+
+template<typename TValue>
+inline void CircularLinkedList<TValue>::push_front(const TValue& val)
+{
+	insertBefore(sentinel.next, val);
+}
+
+template<typename TValue>
+inline void CircularLinkedList<TValue>::push_front(TValue&& val)
+{
+	insertBefore(sentinel.next, std::move(val));
+}
+
+template<typename TValue>
+inline void CircularLinkedList<TValue>::push_back(const TValue& val)
+{
+	insertBefore(&sentinel, val);
+}
+
+template<typename TValue>
+inline void CircularLinkedList<TValue>::push_back(TValue&& val)
+{
+	insertBefore(&sentinel, std::move(val));
+}
+
+template<typename TValue>
+inline TValue& CircularLinkedList<TValue>::front()
+{
+	if (empty()) throw std::runtime_error("list is empty");
+	return toNode(sentinel.next)->value;
+}
+
+template<typename TValue>
+inline const TValue& CircularLinkedList<TValue>::front() const
+{
+	if (empty()) throw std::runtime_error("list is empty");
+	return toNode(sentinel.next)->value;
+}
+
+template<typename TValue>
+inline TValue& CircularLinkedList<TValue>::back()
+{
+	if (empty()) throw std::runtime_error("list is empty");
+	return toNode(sentinel.prev)->value;
+}
+
+template<typename TValue>
+inline const TValue& CircularLinkedList<TValue>::back() const
+{
+	if (empty()) throw std::runtime_error("list is empty");
+	return toNode(sentinel.prev)->value;
+}
+
+template<typename TValue>
+inline TValue CircularLinkedList<TValue>::pop_front()
+{
+	if (empty()) throw std::runtime_error("cannot remove from empty list");
+	return remove(sentinel.next);
+}
+
+template<typename TValue>
+inline TValue CircularLinkedList<TValue>::pop_back()
+{
+	if (empty()) throw std::runtime_error("cannot remove from empty list");
+	return remove(sentinel.prev);
+}
+
+template<typename TValue>
+inline typename CircularLinkedList<TValue>::iterator CircularLinkedList<TValue>::insert(iterator pos, const TValue& val)
+{
+	return iterator(insertBefore(pos.current, val));
+}
+
+template<typename TValue>
+inline typename CircularLinkedList<TValue>::iterator CircularLinkedList<TValue>::erase(iterator pos)
+{
+	auto next = pos.current->next;
+	destroy(pos.current);
+	return iterator(next);
+}
+
+template<typename TValue>
+inline typename CircularLinkedList<TValue>::iterator CircularLinkedList<TValue>::find(const TValue& val)
+{
+	auto n = sentinel.next;
+	while (n != &sentinel && !(toNode(n)->value == val))
+	{
+		n = n->next;
+	}
+	return iterator(n);
+}
+
+template<typename TValue>
+inline bool CircularLinkedList<TValue>::contains(const TValue& val) const
+{
+	for (auto n = sentinel.next; n != &sentinel; n = n->next)
+	{
+		if (toNode(n)->value == val)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+template<typename TValue>
+inline void CircularLinkedList<TValue>::clear() noexcept
+{
+	auto n = sentinel.next;
+	while (n != &sentinel)
+	{
+		auto next = n->next;
+		auto node = toNode(n);
+		node->~Node();
+		NodeCache<Node>::deallocate(node);
+		n = next;
+	}
+	sentinel.next = &sentinel;
+	sentinel.prev = &sentinel;
+	count = 0;
+}
+
+template<typename TValue>
+inline typename CircularLinkedList<TValue>::iterator CircularLinkedList<TValue>::begin() noexcept
+{
+	return iterator(sentinel.next);
+}
+
+template<typename TValue>
+inline typename CircularLinkedList<TValue>::iterator CircularLinkedList<TValue>::end() noexcept
+{
+	return iterator(&sentinel);
+}
+
+template<typename TValue>
+inline std::string CircularLinkedList<TValue>::toString() const
+{
+	std::stringstream ss;
+	for (auto n = sentinel.next; n != &sentinel; n = n->next)
+	{
+		ss << '[' << toNode(n)->value << ']';
+		if (n->next != &sentinel)
+		{
+			ss << "<->";
+		}
+	}
+	return ss.str();
+}
+
+template<typename TValue>
+inline CircularLinkedList<TValue>::Node* CircularLinkedList<TValue>::toNode(Link* link) noexcept
+{
+	return static_cast<Node*>(link);
+}
+
+template<typename TValue>
+inline const CircularLinkedList<TValue>::Node* CircularLinkedList<TValue>::toNode(const Link* link) noexcept
+{
+	return static_cast<const Node*>(link);
+}
+
+template<typename TValue>
+template<typename TArg>
+inline CircularLinkedList<TValue>::Link* CircularLinkedList<TValue>::insertBefore(Link* link, TArg&& val)
+{
+	auto memory = NodeCache<Node>::allocate();
+	Node* node;
+	try
+	{
+		node = ::new (memory) Node(std::forward<TArg>(val));
+	}
+	catch (...)
+	{
+		NodeCache<Node>::deallocate(memory);
+		throw;
+	}
+
+	// the sentinel guarantees both neighbours exist, no head/tail special cases
+	node->next = link;
+	node->prev = link->prev;
+	link->prev->next = node;
+	link->prev = node;
+	count++;
+	return node;
+}
+
+template<typename TValue>
+inline TValue CircularLinkedList<TValue>::remove(Link* link)
+{
+	auto val = std::move(toNode(link)->value);
+	destroy(link);
+	return val;
+}
+
+template<typename TValue>
+inline void CircularLinkedList<TValue>::destroy(Link* link) noexcept
+{
+	link->prev->next = link->next;
+	link->next->prev = link->prev;
+	count--;
+
+	auto node = toNode(link);
+	node->~Node();
+	NodeCache<Node>::deallocate(node);
+}
+
+template<typename TValue>
+inline void CircularLinkedList<TValue>::take(CircularLinkedList& other) noexcept
+{
+	if (other.empty())
+	{
+		return;
+	}
+
+	// the first and last node point at the other list's sentinel
+	sentinel.next = other.sentinel.next;
+	sentinel.prev = other.sentinel.prev;
+	sentinel.next->prev = &sentinel;
+	sentinel.prev->next = &sentinel;
+	count = other.count;
+
+	other.sentinel.next = &other.sentinel;
+	other.sentinel.prev = &other.sentinel;
+	other.count = 0;
+}
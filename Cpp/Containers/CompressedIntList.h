@@ -0,0 +1,677 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#	include <emmintrin.h>
+#	define LIBRARYCPP_COMPRESSEDINTLIST_SSE2 1
+#endif
+
+/**
+
+	@class   CompressedIntList
+	@brief   Sequence of 64-bit integers stored as linked blocks of delta-encoded, bit-packed values
+
+	@details ~ Values are collected uncompressed until BlockValues of them are pending, then packed into a block:
+			   the block keeps it's first value, and for every following value the difference to the previous one,
+			   zigzag encoded so small negative steps stay small, packed with the fewest bits that hold the largest
+			   difference of the block. Sorted or nearly sorted ids therefore take a few bits each instead of 64.
+			   The differences are split over two interleaved bit streams (even and odd positions) that advance
+			   in lockstep, so two values are unpacked per step, with one SSE2 shift where available.
+			   Iteration and merge() decode one value at a time, and pop_front() decodes one block at a time,
+			   the list is never decompressed as a whole. Values can only be added at the back.
+
+**/
+class CompressedIntList
+{
+public:
+	using value_type = std::uint64_t;
+	using size_type = std::size_t;
+
+	// values per compressed block
+	static constexpr size_type BlockValues = 128;
+
+	class iterator;
+	using const_iterator = iterator;
+
+	/**
+		@brief Construct an empty list
+	**/
+	CompressedIntList() noexcept;
+	~CompressedIntList();
+
+	CompressedIntList(const CompressedIntList& other);
+	CompressedIntList(CompressedIntList&& other) noexcept;
+	CompressedIntList& operator=(const CompressedIntList& other);
+	CompressedIntList& operator=(CompressedIntList&& other) noexcept;
+
+	/**
+		@brief  Returns number of values in the list
+
+		Performs in O(1) constant time
+	**/
+	size_type size() const noexcept;
+
+	/**
+		@brief  Determines if the list is empty
+
+		Performs in O(1) constant time
+	**/
+	bool empty() const noexcept;
+
+	/**
+		@brief Add a value to the end of the list
+
+		Performs in O(1) amortized constant time, every BlockValues-th call packs a block
+		@param val - value to add
+	**/
+	void push_back(value_type val);
+
+	/**
+		@brief  Return the first value of the list
+		@exception std::runtime_error if list is empty
+	**/
+	value_type front() const;
+
+	/**
+		@brief  Removes the first value of the list and returns it
+
+		Performs in O(1) amortized constant time, the first block is decoded once when it's first value is removed
+		@exception std::runtime_error if list is empty
+	**/
+	value_type pop_front();
+
+	/**
+		@brief Removes all values of the list
+	**/
+	void clear() noexcept;
+
+	/**
+		@brief Merge another sorted list into this sorted list, the other list is left empty
+
+		Both lists are decoded value by value while the result is packed, never fully decompressed.
+		Performs in O(n + m) linear time, where n and m = the number of values in the lists
+		@param other - sorted list to merge
+	**/
+	void merge(CompressedIntList& other);
+
+	/**
+		@brief Call a function with every value in order, decoding a whole block at a time
+
+		Faster than iterating, this is the bulk decode path
+		@param func - function taking a value_type
+	**/
+	template<typename TFunc>
+	void forEach(TFunc func) const;
+
+	iterator begin() const noexcept;
+	iterator end() const noexcept;
+
+	/**
+		@brief  Bytes of heap memory held by the list
+	**/
+	size_type memoryUsage() const noexcept;
+
+	/**
+		@brief  Average bytes of heap memory per value
+	**/
+	double bytesPerValue() const noexcept;
+
+	/**
+		@brief Get string representation of the list's values suitable for display
+	**/
+	std::string toString() const;
+
+private:
+	// block header, the packed differences follow it in the same allocation
+	struct Block
+	{
+		Block* next;
+		value_type first;
+		std::uint32_t count;
+		std::uint32_t bitWidth;
+		// words of both streams, interleaved: stream s's word w is at words()[2 * w + s]
+		std::uint32_t wordCount;
+
+		std::uint64_t* words() noexcept
+		{
+			return reinterpret_cast<std::uint64_t*>(this + 1);
+		}
+
+		const std::uint64_t* words() const noexcept
+		{
+			return reinterpret_cast<const std::uint64_t*>(this + 1);
+		}
+	};
+
+	Block* head;
+	Block* tail;
+
+	// values added since the last packed block, live from pendingFirst on
+	std::vector<value_type> pending;
+	size_type pendingFirst;
+
+	// the first block decoded, filled on the first pop_front() from it
+	std::vector<value_type> headValues;
+	// number of values already popped from the first block
+	size_type headPopped;
+
+	size_type count;
+	size_type blockBytes;
+
+	// Pack values into a new block at the end of the block chain
+	void packBlock(const value_type* values, size_type n);
+	// Decode all values of a block into out
+	static void decodeBlock(const Block* block, value_type* out) noexcept;
+	// Difference i (of value i + 1) of a block, zigzag encoded
+	static std::uint64_t unpack(const Block* block, size_type i) noexcept;
+
+	static std::uint64_t zigzag(value_type from, value_type to) noexcept;
+	static value_type unzigzag(value_type from, std::uint64_t encoded) noexcept;
+
+	static Block* cloneBlock(const Block* block);
+	static std::size_t blockSize(const Block* block) noexcept;
+};
+
+/**
+	@class  CompressedIntList::iterator
+	@brief  Forward iterator decoding the values of a CompressedIntList one at a time
+**/
+class CompressedIntList::iterator
+{
+public:
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = CompressedIntList::value_type;
+	using difference_type = std::ptrdiff_t;
+	using pointer = const value_type*;
+	using reference = value_type;
+
+	iterator() noexcept
+		: list(nullptr)
+		, block(nullptr)
+		, index(0)
+		, value(0)
+	{}
+
+	value_type operator*() const noexcept
+	{
+		return block != nullptr ? value : list->pending[index];
+	}
+
+	iterator& operator++() noexcept
+	{
+		if (block == nullptr)
+		{
+			index++;
+		}
+		else if (++index < block->count)
+		{
+			value = CompressedIntList::unzigzag(value, CompressedIntList::unpack(block, index - 1));
+		}
+		else
+		{
+			block = block->next;
+			index = block != nullptr ? 0 : list->pendingFirst;
+			value = block != nullptr ? block->first : 0;
+		}
+		return *this;
+	}
+
+	iterator operator++(int) noexcept
+	{
+		auto it = *this;
+		++*this;
+		return it;
+	}
+
+	bool operator==(const iterator& other) const noexcept
+	{
+		return block == other.block && index == other.index;
+	}
+
+	bool operator!=(const iterator& other) const noexcept
+	{
+		return !(*this == other);
+	}
+
+private:
+	const CompressedIntList* list;
+	// current block, nullptr once in the pending values
+	const Block* block;
+	// position in the block or in pending
+	size_type index;
+	// decoded value at index, only used inside blocks
+	value_type value;
+
+	iterator(const CompressedIntList* list, const Block* block, size_type index, value_type value) noexcept
+		: list(list)
+		, block(block)
+		, index(index)
+		, value(value)
+	{}
+
+	friend class CompressedIntList;
+};
+
+inline CompressedIntList::CompressedIntList() noexcept
+	: head(nullptr)
+	, tail(nullptr)
+	, pending()
+	, pendingFirst(0)
+	, headValues()
+	, headPopped(0)
+	, count(0)
+	, blockBytes(0)
+{}
+
+inline CompressedIntList::~CompressedIntList()
+{
+	clear();
+}
+
+inline CompressedIntList::CompressedIntList(const CompressedIntList& other)
+	: CompressedIntList()
+{
+	*this = other;
+}
+
+inline CompressedIntList::CompressedIntList(CompressedIntList&& other) noexcept
+	: head(std::exchange(other.head, nullptr))
+	, tail(std::exchange(other.tail, nullptr))
+	, pending(std::move(other.pending))
+	, pendingFirst(std::exchange(other.pendingFirst, 0))
+	, headValues(std::move(other.headValues))
+	, headPopped(std::exchange(other.headPopped, 0))
+	, count(std::exchange(other.count, 0))
+	, blockBytes(std::exchange(other.blockBytes, 0))
+{}
+
+inline CompressedIntList& CompressedIntList::operator=(const CompressedIntList& other)
+{
+	if (this != &other)
+	{
+		clear();
+		// blocks are copied as packed bytes
+		for (auto b = other.head; b != nullptr; b = b->next)
+		{
+			auto copy = cloneBlock(b);
+			(tail != nullptr ? tail->next : head) = copy;
+			tail = copy;
+			blockBytes += blockSize(copy);
+		}
+		pending = other.pending;
+		pendingFirst = other.pendingFirst;
+		headValues = other.headValues;
+		headPopped = other.headPopped;
+		count = other.count;
+	}
+	return *this;
+}
+
+inline CompressedIntList& CompressedIntList::operator=(CompressedIntList&& other) noexcept
+{
+	if (this != &other)
+	{
+		clear();
+		head = std::exchange(other.head, nullptr);
+		tail = std::exchange(other.tail, nullptr);
+		pending = std::move(other.pending);
+		pendingFirst = std::exchange(other.pendingFirst, 0);
+		headValues = std::move(other.headValues);
+		headPopped = std::exchange(other.headPopped, 0);
+		count = std::exchange(other.count, 0);
+		blockBytes = std::exchange(other.blockBytes, 0);
+	}
+	return *this;
+}
+
+inline std::size_t CompressedIntList::size() const noexcept
+{
+	return count;
+}
+
+inline bool CompressedIntList::empty() const noexcept
+{
+	return count == 0;
+}
+
+inline void CompressedIntList::push_back(value_type val)
+{
+	if (pending.capacity() == 0)
+	{
+		pending.reserve(BlockValues);
+	}
+	pending.push_back(val);
+	count++;
+
+	if (pending.size() - pendingFirst == BlockValues)
+	{
+		packBlock(pending.data() + pendingFirst, BlockValues);
+		pending.clear();
+		pendingFirst = 0;
+	}
+}
+
+inline CompressedIntList::value_type CompressedIntList::front() const
+{
+	if (count == 0) throw std::runtime_error("list is empty");
+
+	if (head == nullptr)
+	{
+		return pending[pendingFirst];
+	}
+	return headValues.empty() ? head->first : headValues[headPopped];
+}
+
+inline CompressedIntList::value_type CompressedIntList::pop_front()
+{
+	if (count == 0) throw std::runtime_error("cannot remove from empty list");
+	count--;
+
+	if (head == nullptr)
+	{
+		auto val = pending[pendingFirst++];
+		if (pendingFirst == pending.size())
+		{
+			pending.clear();
+			pendingFirst = 0;
+		}
+		else if (pendingFirst >= BlockValues || 2 * pendingFirst >= pending.size())
+		{
+			// a queue that never has BlockValues values live would otherwise grow pending forever
+			pending.erase(pending.begin(), pending.begin() + pendingFirst);
+			pendingFirst = 0;
+		}
+		return val;
+	}
+
+	if (headValues.empty())
+	{
+		headValues.resize(BlockValues);
+		decodeBlock(head, headValues.data());
+	}
+
+	auto val = headValues[headPopped++];
+	if (headPopped == head->count)
+	{
+		auto block = head;
+		head = head->next;
+		if (head == nullptr)
+		{
+			tail = nullptr;
+		}
+		blockBytes -= blockSize(block);
+		::operator delete(block);
+		headValues.clear();
+		headPopped = 0;
+	}
+	return val;
+}
+
+inline void CompressedIntList::clear() noexcept
+{
+	while (head != nullptr)
+	{
+		auto next = head->next;
+		::operator delete(head);
+		head = next;
+	}
+	tail = nullptr;
+	pending.clear();
+	pendingFirst = 0;
+	headValues.clear();
+	headPopped = 0;
+	count = 0;
+	blockBytes = 0;
+}
+
+inline void CompressedIntList::merge(CompressedIntList& other)
+{
+	if (this == &other)
+	{
+		return;
+	}
+
+	CompressedIntList merged;
+	auto a = begin();
+	auto b = other.begin();
+	auto aEnd = end();
+	auto bEnd = other.end();
+	while (a != aEnd && b != bEnd)
+	{
+		// take from this list on ties, like std::list::merge
+		if (*b < *a)
+		{
+			merged.push_back(*b);
+			++b;
+		}
+		else
+		{
+			merged.push_back(*a);
+			++a;
+		}
+	}
+	for (; a != aEnd; ++a)
+	{
+		merged.push_back(*a);
+	}
+	for (; b != bEnd; ++b)
+	{
+		merged.push_back(*b);
+	}
+
+	*this = std::move(merged);
+	other.clear();
+}
+
+template<typename TFunc>
+inline void CompressedIntList::forEach(TFunc func) const
+{
+	value_type values[BlockValues];
+	for (auto b = head; b != nullptr; b = b->next)
+	{
+		decodeBlock(b, values);
+		for (size_type i = b == head ? headPopped : 0; i < b->count; i++)
+		{
+			func(values[i]);
+		}
+	}
+	for (auto i = pendingFirst; i < pending.size(); i++)
+	{
+		func(pending[i]);
+	}
+}
+
+inline CompressedIntList::iterator CompressedIntList::begin() const noexcept
+{
+	if (head == nullptr)
+	{
+		return iterator(this, nullptr, pendingFirst, 0);
+	}
+	if (!headValues.empty())
+	{
+		// part of the first block was popped, continue from the decoded copy
+		return iterator(this, head, headPopped, headValues[headPopped]);
+	}
+	return iterator(this, head, 0, head->first);
+}
+
+inline CompressedIntList::iterator CompressedIntList::end() const noexcept
+{
+	return iterator(this, nullptr, pending.size(), 0);
+}
+
+inline std::size_t CompressedIntList::memoryUsage() const noexcept
+{
+	return blockBytes + (pending.capacity() + headValues.capacity()) * sizeof(value_type);
+}
+
+inline double CompressedIntList::bytesPerValue() const noexcept
+{
+	return count > 0 ? static_cast<double>(memoryUsage()) / static_cast<double>(count) : 0.0;
+}
+
+inline std::string CompressedIntList::toString() const
+{
+	std::stringstream ss;
+	const char* separator = "";
+	forEach([&](value_type val) {
+		ss << separator << val;
+		separator = ", ";
+	});
+	return ss.str();
+}
+
+inline void CompressedIntList::packBlock(const value_type* values, size_type n)
+{
+	std::uint64_t widest = 0;
+	for (size_type i = 1; i < n; i++)
+	{
+		widest |= zigzag(values[i - 1], values[i]);
+	}
+	auto bitWidth = static_cast<std::uint32_t>(std::bit_width(widest));
+
+	// difference i goes to stream i % 2 at bit (i / 2) * bitWidth; one spare word per stream lets
+	// unpacking read the following word unconditionally
+	auto steps = n / 2;
+	auto wordsPerStream = (steps * bitWidth + 63) / 64 + 1;
+	auto wordCount = static_cast<std::uint32_t>(2 * wordsPerStream);
+
+	auto block = static_cast<Block*>(::operator new(sizeof(Block) + wordCount * sizeof(std::uint64_t)));
+	block->next = nullptr;
+	block->first = values[0];
+	block->count = static_cast<std::uint32_t>(n);
+	block->bitWidth = bitWidth;
+	block->wordCount = wordCount;
+
+	auto words = block->words();
+	std::memset(words, 0, wordCount * sizeof(std::uint64_t));
+	if (bitWidth > 0)
+	{
+		for (size_type i = 0; i + 1 < n; i++)
+		{
+			auto bit = (i / 2) * bitWidth;
+			auto word = 2 * (bit / 64) + i % 2;
+			auto shift = bit % 64;
+			auto encoded = zigzag(values[i], values[i + 1]);
+			words[word] |= encoded << shift;
+			if (shift + bitWidth > 64)
+			{
+				words[word + 2] |= encoded >> (64 - shift);
+			}
+		}
+	}
+
+	(tail != nullptr ? tail->next : head) = block;
+	tail = block;
+	blockBytes += blockSize(block);
+}
+
+inline void CompressedIntList::decodeBlock(const Block* block, value_type* out) noexcept
+{
+	out[0] = block->first;
+	auto n = static_cast<size_type>(block->count);
+	auto bitWidth = block->bitWidth;
+	if (bitWidth == 0)
+	{
+		for (size_type i = 1; i < n; i++)
+		{
+			out[i] = out[0];
+		}
+		return;
+	}
+
+	auto words = block->words();
+	auto mask = bitWidth == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << bitWidth) - 1;
+	size_type i = 0;
+	std::size_t bit = 0;
+
+#ifdef LIBRARYCPP_COMPRESSEDINTLIST_SSE2
+	// both streams sit at the same bit offset, so one 128-bit shift unpacks differences i and i + 1
+	auto maskBits = _mm_set1_epi64x(static_cast<long long>(mask));
+	auto one = _mm_set1_epi64x(1);
+	auto zero = _mm_setzero_si128();
+	auto previous = _mm_set1_epi64x(static_cast<long long>(out[0]));
+	for (; i + 2 < n; i += 2, bit += bitWidth)
+	{
+		auto word = 2 * (bit / 64);
+		auto shift = static_cast<int>(bit % 64);
+		auto low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(words + word));
+		auto encoded = _mm_srl_epi64(low, _mm_cvtsi32_si128(shift));
+		if (shift + bitWidth > 64)
+		{
+			auto high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(words + word + 2));
+			encoded = _mm_or_si128(encoded, _mm_sll_epi64(high, _mm_cvtsi32_si128(64 - shift)));
+		}
+		encoded = _mm_and_si128(encoded, maskBits);
+
+		// zigzag decode: (e >> 1) ^ -(e & 1)
+		auto delta = _mm_xor_si128(_mm_srli_epi64(encoded, 1), _mm_sub_epi64(zero, _mm_and_si128(encoded, one)));
+		// prefix sum of the two lanes, then add the last decoded value
+		delta = _mm_add_epi64(delta, _mm_slli_si128(delta, 8));
+		auto values = _mm_add_epi64(delta, previous);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 1), values);
+		previous = _mm_unpackhi_epi64(values, values);
+	}
+#endif
+
+	for (; i + 1 < n; i++)
+	{
+		out[i + 1] = unzigzag(out[i], unpack(block, i));
+	}
+}
+
+inline std::uint64_t CompressedIntList::unpack(const Block* block, size_type i) noexcept
+{
+	auto bitWidth = block->bitWidth;
+	if (bitWidth == 0)
+	{
+		return 0;
+	}
+
+	auto bit = (i / 2) * bitWidth;
+	auto word = 2 * (bit / 64) + i % 2;
+	auto shift = bit % 64;
+	auto words = block->words();
+	auto encoded = words[word] >> shift;
+	if (shift + bitWidth > 64)
+	{
+		encoded |= words[word + 2] << (64 - shift);
+	}
+	return bitWidth == 64 ? encoded : encoded & ((std::uint64_t(1) << bitWidth) - 1);
+}
+
+inline std::uint64_t CompressedIntList::zigzag(value_type from, value_type to) noexcept
+{
+	auto delta = to - from;
+	return (delta << 1) ^ static_cast<std::uint64_t>(static_cast<std::int64_t>(delta) >> 63);
+}
+
+inline CompressedIntList::value_type CompressedIntList::unzigzag(value_type from, std::uint64_t encoded) noexcept
+{
+	return from + ((encoded >> 1) ^ (~(encoded & 1) + 1));
+}
+
+inline CompressedIntList::Block* CompressedIntList::cloneBlock(const Block* block)
+{
+	auto size = blockSize(block);
+	auto copy = static_cast<Block*>(::operator new(size));
+	std::memcpy(static_cast<void*>(copy), block, size);
+	copy->next = nullptr;
+	return copy;
+}
+
+inline std::size_t CompressedIntList::blockSize(const Block* block) noexcept
+{
+	return sizeof(Block) + block->wordCount * sizeof(std::uint64_t);
+}
@@ -0,0 +1,383 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "ThreadRandom.h"
+
+/**
+
+	@class   ConcurrentStack
+	@brief   Lock-free LIFO stack (Treiber stack) with an elimination array for contended pushes and pops
+
+	@details ~ Nodes have LinkedList's shape, a link and a value, but are addressed by 32-bit index and never returned to the heap
+			   while the stack lives: popped nodes go onto a lock-free free list and are reused by later pushes. The stack and
+			   free-list heads pack a 32-bit version tag next to the index and every successful CAS increments it, so a head
+			   that was popped and pushed back between a thread's read and it's CAS (the ABA problem) is detected, and reading
+			   the link of a node another thread just popped is always safe.
+			   When the CAS on the head fails, the thread tries the elimination array: a push offers it's node in a random slot
+			   and waits briefly, a pop takes an offered node from a random slot. A matched pair completes without touching
+			   the head at all, so throughput under contention does not collapse on the single head word.
+			   Nodes are kept in chunks that double in size, so the stack grows without a capacity limit (up to 2^32 nodes)
+			   and never moves a node.
+	@tparam  TValue - type of stack's values, must be move constructible
+
+**/
+template<typename TValue>
+class ConcurrentStack
+{
+public:
+	using value_type = TValue;
+	using size_type = std::size_t;
+
+	/**
+		@brief Construct an empty stack, no memory is allocated until the first push
+	**/
+	ConcurrentStack() noexcept;
+
+	/**
+		@brief Destroys the values left in the stack and frees all nodes; no other thread may use the stack
+	**/
+	~ConcurrentStack();
+
+	ConcurrentStack(const ConcurrentStack&) = delete;
+	ConcurrentStack& operator=(const ConcurrentStack&) = delete;
+
+	/**
+		@brief Add a value to the top of the stack, safe to call from any thread
+
+		Performs in O(1) constant time, lock-free
+		@param val - value to add
+	**/
+	void push(const TValue& val);
+	void push(TValue&& val);
+
+	/**
+		@brief  Removes the value at the top of the stack and returns it, safe to call from any thread
+
+		Performs in O(1) constant time, lock-free
+		@exception std::runtime_error if stack is empty
+	**/
+	value_type pop();
+
+	/**
+		@brief  Removes the value at the top of the stack, if there is one
+
+		Performs in O(1) constant time, lock-free
+		@param  out - receives the removed value
+		@retval bool true if a value was removed, false if the stack is empty
+	**/
+	bool try_pop(TValue& out);
+
+	/**
+		@brief  Determines if the stack was empty at the moment of the call
+	**/
+	bool empty() const noexcept;
+
+	/**
+		@brief  Number of pushes handed directly to a pop through the elimination array
+	**/
+	std::size_t eliminated() const noexcept;
+
+private:
+	struct Node
+	{
+		// index + 1 of the node below, 0 at the bottom
+		std::atomic<std::uint32_t> next;
+		alignas(TValue) unsigned char storage[sizeof(TValue)];
+
+		TValue* value() noexcept
+		{
+			return std::launder(reinterpret_cast<TValue*>(storage));
+		}
+	};
+
+	// head word: version tag in the high 32 bits, index + 1 of the top node in the low 32 bits (0 = empty)
+	using Head = std::uint64_t;
+
+	// chunk k holds FirstChunk << k nodes, 27 chunks cover every 32-bit index
+	static constexpr std::size_t FirstChunkBits = 6;
+	static constexpr std::size_t FirstChunk = std::size_t(1) << FirstChunkBits;
+	static constexpr std::size_t MaxChunks = 27;
+
+	static constexpr std::size_t EliminationSlots = 16;
+	// attempts a push waits for a pop to take it's offer
+	static constexpr int EliminationSpins = 64;
+
+	struct alignas(64) Slot
+	{
+		// offer: stamp in the high 32 bits, node index + 1 in the low 32 bits; 0 = no offer
+		std::atomic<std::uint64_t> offer;
+	};
+
+	alignas(64) std::atomic<Head> head;
+	alignas(64) std::atomic<Head> freeHead;
+	alignas(64) std::atomic<std::uint32_t> used;
+	std::atomic<Node*> chunks[MaxChunks];
+
+	Slot slots[EliminationSlots];
+	std::atomic<std::uint32_t> stamps;
+	std::atomic<std::size_t> eliminatedCount;
+
+	// Node at an index, it's chunk must exist
+	Node& node(std::uint32_t index) noexcept;
+
+	// Take a node from the free list or the never used ones
+	std::uint32_t allocateNode();
+
+	// Treiber push and pop of a node index on a head word; pop returns index + 1, 0 if empty
+	void pushIndex(std::atomic<Head>& top, std::uint32_t index) noexcept;
+	bool tryPushIndex(std::atomic<Head>& top, std::uint32_t index) noexcept;
+	std::uint32_t popIndex(std::atomic<Head>& top) noexcept;
+	// one CAS attempt; returns false on contention, sets taken to index + 1 or 0 if empty
+	bool tryPopIndex(std::atomic<Head>& top, std::uint32_t& taken) noexcept;
+
+	// Elimination: offer a pushed node to a pop / take an offered node; return true on a match
+	bool offer(std::uint32_t index) noexcept;
+	bool takeOffer(std::uint32_t& index) noexcept;
+
+	template<typename TArg>
+	void add(TArg&& val);
+	// Pop a node from the head or the elimination array; returns index + 1, 0 if the stack is empty
+	std::uint32_t takeNode() noexcept;
+};
+
+template<typename TValue>
+inline ConcurrentStack<TValue>::ConcurrentStack() noexcept
+	: head(0)
+	, freeHead(0)
+	, used(0)
+	, chunks()
+	, slots()
+	, stamps(0)
+	, eliminatedCount(0)
+{}
+
+template<typename TValue>
+inline ConcurrentStack<TValue>::~ConcurrentStack()
+{
+	if constexpr (!std::is_trivially_destructible_v<TValue>)
+	{
+		for (auto top = static_cast<std::uint32_t>(head.load(std::memory_order_acquire)); top != 0; )
+		{
+			auto& n = node(top - 1);
+			n.value()->~TValue();
+			top = n.next.load(std::memory_order_relaxed);
+		}
+	}
+	for (std::size_t k = 0; k < MaxChunks; k++)
+	{
+		delete[] chunks[k].load(std::memory_order_relaxed);
+	}
+}
+
+template<typename TValue>
+inline void ConcurrentStack<TValue>::push(const TValue& val)
+{
+	add(val);
+}
+
+template<typename TValue>
+inline void ConcurrentStack<TValue>::push(TValue&& val)
+{
+	add(std::move(val));
+}
+
+template<typename TValue>
+inline TValue ConcurrentStack<TValue>::pop()
+{
+	auto taken = takeNode();
+	if (taken == 0) throw std::runtime_error("cannot remove from empty list");
+
+	auto& n = node(taken - 1);
+	TValue val = std::move(*n.value());
+	n.value()->~TValue();
+	pushIndex(freeHead, taken - 1);
+	return val;
+}
+
+template<typename TValue>
+inline bool ConcurrentStack<TValue>::try_pop(TValue& out)
+{
+	auto taken = takeNode();
+	if (taken == 0)
+	{
+		return false;
+	}
+
+	auto& n = node(taken - 1);
+	out = std::move(*n.value());
+	n.value()->~TValue();
+	pushIndex(freeHead, taken - 1);
+	return true;
+}
+
+template<typename TValue>
+inline bool ConcurrentStack<TValue>::empty() const noexcept
+{
+	return static_cast<std::uint32_t>(head.load(std::memory_order_acquire)) == 0;
+}
+
+template<typename TValue>
+inline std::size_t ConcurrentStack<TValue>::eliminated() const noexcept
+{
+	return eliminatedCount.load(std::memory_order_relaxed);
+}
+
+template<typename TValue>
+inline ConcurrentStack<TValue>::Node& ConcurrentStack<TValue>::node(std::uint32_t index) noexcept
+{
+	// chunk k starts at index FirstChunk * (2^k - 1)
+	auto block = (static_cast<std::size_t>(index) >> FirstChunkBits) + 1;
+	auto k = static_cast<std::size_t>(std::bit_width(block)) - 1;
+	auto offset = static_cast<std::size_t>(index) - FirstChunk * ((std::size_t(1) << k) - 1);
+	return chunks[k].load(std::memory_order_acquire)[offset];
+}
+
+template<typename TValue>
+inline std::uint32_t ConcurrentStack<TValue>::allocateNode()
+{
+	if (auto reused = popIndex(freeHead))
+	{
+		return reused - 1;
+	}
+
+	auto index = used.fetch_add(1, std::memory_order_relaxed);
+	if (index == static_cast<std::uint32_t>(-1)) throw std::bad_alloc();
+
+	auto block = (static_cast<std::size_t>(index) >> FirstChunkBits) + 1;
+	auto k = static_cast<std::size_t>(std::bit_width(block)) - 1;
+	if (chunks[k].load(std::memory_order_acquire) == nullptr)
+	{
+		// several threads may race to create the chunk, the losers free theirs
+		auto chunk = new Node[FirstChunk << k];
+		Node* expected = nullptr;
+		if (!chunks[k].compare_exchange_strong(expected, chunk, std::memory_order_acq_rel))
+		{
+			delete[] chunk;
+		}
+	}
+	return index;
+}
+
+template<typename TValue>
+inline void ConcurrentStack<TValue>::pushIndex(std::atomic<Head>& top, std::uint32_t index) noexcept
+{
+	while (!tryPushIndex(top, index))
+	{
+	}
+}
+
+template<typename TValue>
+inline bool ConcurrentStack<TValue>::tryPushIndex(std::atomic<Head>& top, std::uint32_t index) noexcept
+{
+	auto old = top.load(std::memory_order_relaxed);
+	node(index).next.store(static_cast<std::uint32_t>(old), std::memory_order_relaxed);
+	auto tagged = (((old >> 32) + 1) << 32) | (static_cast<Head>(index) + 1);
+	return top.compare_exchange_weak(old, tagged, std::memory_order_release, std::memory_order_relaxed);
+}
+
+template<typename TValue>
+inline std::uint32_t ConcurrentStack<TValue>::popIndex(std::atomic<Head>& top) noexcept
+{
+	std::uint32_t taken;
+	while (!tryPopIndex(top, taken))
+	{
+	}
+	return taken;
+}
+
+template<typename TValue>
+inline bool ConcurrentStack<TValue>::tryPopIndex(std::atomic<Head>& top, std::uint32_t& taken) noexcept
+{
+	auto old = top.load(std::memory_order_acquire);
+	taken = static_cast<std::uint32_t>(old);
+	if (taken == 0)
+	{
+		return true;
+	}
+	// the node may be popped and reused meanwhile; then the tag has changed and the CAS fails
+	auto next = node(taken - 1).next.load(std::memory_order_relaxed);
+	auto tagged = (((old >> 32) + 1) << 32) | next;
+	return top.compare_exchange_weak(old, tagged, std::memory_order_acquire, std::memory_order_relaxed);
+}
+
+template<typename TValue>
+inline bool ConcurrentStack<TValue>::offer(std::uint32_t index) noexcept
+{
+	auto& slot = slots[threadRandom() % EliminationSlots];
+	// the stamp makes every offer unique, so a withdrawn offer is never confused with a later one for the same node
+	auto stamp = static_cast<std::uint64_t>(stamps.fetch_add(1, std::memory_order_relaxed));
+	auto mine = (stamp << 32) | (static_cast<std::uint64_t>(index) + 1);
+
+	std::uint64_t expected = 0;
+	if (!slot.offer.compare_exchange_strong(expected, mine, std::memory_order_release, std::memory_order_relaxed))
+	{
+		return false;
+	}
+	for (int i = 0; i < EliminationSpins; i++)
+	{
+		if (slot.offer.load(std::memory_order_acquire) != mine)
+		{
+			return true;
+		}
+	}
+	// withdraw; if that fails a pop took the offer in the meantime
+	return !slot.offer.compare_exchange_strong(mine, 0, std::memory_order_acquire, std::memory_order_acquire);
+}
+
+template<typename TValue>
+inline bool ConcurrentStack<TValue>::takeOffer(std::uint32_t& index) noexcept
+{
+	auto& slot = slots[threadRandom() % EliminationSlots];
+	auto seen = slot.offer.load(std::memory_order_acquire);
+	if (seen == 0 || !slot.offer.compare_exchange_strong(seen, 0, std::memory_order_acquire, std::memory_order_relaxed))
+	{
+		return false;
+	}
+	index = static_cast<std::uint32_t>(seen) - 1;
+	eliminatedCount.fetch_add(1, std::memory_order_relaxed);
+	return true;
+}
+
+template<typename TValue>
+template<typename TArg>
+inline void ConcurrentStack<TValue>::add(TArg&& val)
+{
+	auto index = allocateNode();
+	try
+	{
+		::new (node(index).storage) TValue(std::forward<TArg>(val));
+	}
+	catch (...)
+	{
+		pushIndex(freeHead, index);
+		throw;
+	}
+
+	// contended head: try to hand the node straight to a pop before trying the head again
+	while (!tryPushIndex(head, index) && !offer(index))
+	{
+	}
+}
+
+template<typename TValue>
+inline std::uint32_t ConcurrentStack<TValue>::takeNode() noexcept
+{
+	std::uint32_t taken;
+	while (!tryPopIndex(head, taken))
+	{
+		// contended head: try to take a node a push is offering
+		std::uint32_t index;
+		if (takeOffer(index))
+		{
+			return index + 1;
+		}
+	}
+	return taken;
+}
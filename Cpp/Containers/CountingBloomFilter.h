@@ -0,0 +1,227 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include "HashMix.h"
+
+/**
+
+	@class   CountingBloomFilter
+	@brief   Blocked, counting Bloom filter for approximate membership tests
+
+	@details ~ Every value hashes to one 64-byte block (a single cache line) and sets NumProbes 4-bit counters inside it,
+			   so a lookup touches one cache line. Counters (instead of bits) allow values to be removed again.
+			   A counter that reaches its maximum sticks there and is never decremented, which can only cause
+			   extra false positives, never false negatives.
+	@tparam  TValue - type of values tested against the filter
+	@tparam  THash  - hash function object for TValue
+
+**/
+template<typename TValue, typename THash = std::hash<TValue>>
+class CountingBloomFilter
+{
+public:
+	// counters reserved per expected value, 12 x 4 bits = 6 bytes per value
+	static constexpr std::size_t CountersPerValue = 12;
+	// counters set per value
+	static constexpr std::size_t NumProbes = 6;
+
+	/**
+		@brief Construct a filter sized for the given number of values
+		@param expectedValues - number of values the filter is expected to hold
+	**/
+	explicit CountingBloomFilter(std::size_t expectedValues = 1024);
+
+	/**
+		@brief Record a value in the filter
+
+		Performs in O(1) constant time
+		@param val - value to add
+	**/
+	void insert(const TValue& val) noexcept;
+
+	/**
+		@brief Forget a value previously added with insert()
+
+		Performs in O(1) constant time
+		@param val - value to remove, must have been inserted before
+	**/
+	void remove(const TValue& val) noexcept;
+
+	/**
+		@brief  Test whether a value may have been inserted
+
+		Performs in O(1) constant time
+		@param  val - value to test
+		@retval bool false if the value was definitely not inserted, true if it may have been
+	**/
+	bool mayContain(const TValue& val) const noexcept;
+
+	/**
+		@brief Reset all counters, keeping the current size
+	**/
+	void clear() noexcept;
+
+	/**
+		@brief Reset all counters and resize the filter for a new number of expected values
+		@param expectedValues - number of values the filter is expected to hold
+	**/
+	void reset(std::size_t expectedValues);
+
+	/**
+		@brief  Number of values the filter was sized for
+	**/
+	std::size_t capacity() const noexcept;
+
+	/**
+		@brief  Number of counters that reached their maximum and can no longer be decremented
+	**/
+	std::size_t saturatedCounters() const noexcept;
+
+	/**
+		@brief  Size of the counter storage in bytes
+	**/
+	std::size_t memoryUsage() const noexcept;
+
+private:
+	// 8 x 64-bit words = one 64-byte block of 128 4-bit counters
+	static constexpr std::size_t WordsPerBlock = 8;
+	static constexpr std::size_t CountersPerWord = 16;
+	static constexpr std::uint64_t CounterMax = 0xF;
+
+	std::vector<std::uint64_t> words;
+	std::size_t blockCount;
+	std::size_t expected;
+	std::size_t saturated;
+
+	THash hasher;
+
+	// Index of the first word of the block the hash selects
+	std::size_t blockOf(std::uint64_t h) const noexcept;
+
+	// Bits for selecting counters within the block, independent of the bits used by blockOf()
+	static std::uint64_t probeBits(std::uint64_t h) noexcept;
+};
+
+template<typename TValue, typename THash>
+inline CountingBloomFilter<TValue, THash>::CountingBloomFilter(std::size_t expectedValues)
+	: blockCount(0)
+	, expected(0)
+	, saturated(0)
+{
+	reset(expectedValues);
+}
+
+template<typename TValue, typename THash>
+inline void CountingBloomFilter<TValue, THash>::insert(const TValue& val) noexcept
+{
+	auto h = mixHash(hasher(val));
+	auto block = blockOf(h);
+	auto bits = probeBits(h);
+	for (std::size_t i = 0; i < NumProbes; i++)
+	{
+		// 7 bits per probe select one of the block's 128 counters
+		auto counter = (bits >> (i * 7)) & 0x7F;
+		auto& word = words[block + counter / CountersPerWord];
+		auto shift = (counter % CountersPerWord) * 4;
+		auto value = (word >> shift) & CounterMax;
+		if (value < CounterMax)
+		{
+			word += std::uint64_t(1) << shift;
+			if (value + 1 == CounterMax)
+			{
+				saturated++;
+			}
+		}
+	}
+}
+
+template<typename TValue, typename THash>
+inline void CountingBloomFilter<TValue, THash>::remove(const TValue& val) noexcept
+{
+	auto h = mixHash(hasher(val));
+	auto block = blockOf(h);
+	auto bits = probeBits(h);
+	for (std::size_t i = 0; i < NumProbes; i++)
+	{
+		auto counter = (bits >> (i * 7)) & 0x7F;
+		auto& word = words[block + counter / CountersPerWord];
+		auto shift = (counter % CountersPerWord) * 4;
+		auto value = (word >> shift) & CounterMax;
+		// saturated counters lost track of their real count and stay put
+		if (value > 0 && value < CounterMax)
+		{
+			word -= std::uint64_t(1) << shift;
+		}
+	}
+}
+
+template<typename TValue, typename THash>
+inline bool CountingBloomFilter<TValue, THash>::mayContain(const TValue& val) const noexcept
+{
+	auto h = mixHash(hasher(val));
+	auto block = blockOf(h);
+	auto bits = probeBits(h);
+	for (std::size_t i = 0; i < NumProbes; i++)
+	{
+		auto counter = (bits >> (i * 7)) & 0x7F;
+		auto word = words[block + counter / CountersPerWord];
+		if (((word >> ((counter % CountersPerWord) * 4)) & CounterMax) == 0)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+template<typename TValue, typename THash>
+inline void CountingBloomFilter<TValue, THash>::clear() noexcept
+{
+	std::fill(words.begin(), words.end(), 0);
+	saturated = 0;
+}
+
+template<typename TValue, typename THash>
+inline void CountingBloomFilter<TValue, THash>::reset(std::size_t expectedValues)
+{
+	expected = expectedValues > 0 ? expectedValues : 1;
+	auto counters = expected * CountersPerValue;
+	blockCount = (counters + WordsPerBlock * CountersPerWord - 1) / (WordsPerBlock * CountersPerWord);
+	words.assign(blockCount * WordsPerBlock, 0);
+	saturated = 0;
+}
+
+template<typename TValue, typename THash>
+inline std::size_t CountingBloomFilter<TValue, THash>::capacity() const noexcept
+{
+	return expected;
+}
+
+template<typename TValue, typename THash>
+inline std::size_t CountingBloomFilter<TValue, THash>::saturatedCounters() const noexcept
+{
+	return saturated;
+}
+
+template<typename TValue, typename THash>
+inline std::size_t CountingBloomFilter<TValue, THash>::memoryUsage() const noexcept
+{
+	return words.size() * sizeof(std::uint64_t);
+}
+
+template<typename TValue, typename THash>
+inline std::size_t CountingBloomFilter<TValue, THash>::blockOf(std::uint64_t h) const noexcept
+{
+	// map the high 32 bits onto [0, blockCount) without a division
+	auto block = ((h >> 32) * static_cast<std::uint64_t>(blockCount)) >> 32;
+	return static_cast<std::size_t>(block) * WordsPerBlock;
+}
+
+template<typename TValue, typename THash>
+inline std::uint64_t CountingBloomFilter<TValue, THash>::probeBits(std::uint64_t h) noexcept
+{
+	return mixHash(h + 0x9e3779b97f4a7c15ULL);
+}
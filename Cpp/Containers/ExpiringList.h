@@ -0,0 +1,520 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include "NodeChunks.h"
+
+/**
+
+	@class   ExpiringList
+	@brief   Time-ordered singly-linked list of timestamped values for sliding windows
+
+	@details ~ Values are appended with non-decreasing timestamps, so the expired values always form a prefix of the list.
+			   expire_before() finds the end of that prefix, detaches the whole prefix by moving the head once,
+			   and returns all of it's nodes to the free list with a single splice instead of freeing them one by one.
+			   Node memory is allocated in chunks and recycled through the free list, so a window in steady state
+			   does not allocate at all.
+			   With a time-to-live set, front(), pop_front() and begin() first expire everything older than
+			   now - time-to-live. size() and empty() are not lazily expired, call expire() before them
+			   for an up to date count.
+	@tparam  TValue - type of list's values
+	@tparam  TClock - clock providing the timestamps, e.g. std::chrono::steady_clock
+
+**/
+template<typename TValue, typename TClock = std::chrono::steady_clock>
+class ExpiringList
+{
+public:
+	using value_type = TValue;
+	using reference = value_type&;
+	using const_reference = const value_type&;
+	using size_type = std::size_t;
+	using clock = TClock;
+	using time_point = typename TClock::time_point;
+	using duration = typename TClock::duration;
+
+	class iterator;
+
+	/**
+		@brief Construct an empty list without a time-to-live, values only expire through expire_before()
+	**/
+	ExpiringList() noexcept;
+
+	/**
+		@brief Construct an empty list whose values expire lazily once they are older than the time-to-live
+		@param timeToLive - age after which values expire
+	**/
+	explicit ExpiringList(duration timeToLive) noexcept;
+
+	~ExpiringList();
+
+	ExpiringList(const ExpiringList&) = delete;
+	ExpiringList& operator=(const ExpiringList&) = delete;
+
+	/**
+		@brief  Returns size of the list, including expired values that were not removed yet
+
+		Performs in O(1) constant time
+	**/
+	size_type size() const noexcept;
+
+	/**
+		@brief  Determines if the list is empty, expired values that were not removed yet count as values
+
+		Performs in O(1) constant time
+	**/
+	bool empty() const noexcept;
+
+	/**
+		@brief Add a value stamped with the current time of the clock
+
+		Performs in O(1) amortized constant time
+		@param val - value to add
+	**/
+	void push_back(const TValue& val);
+
+	/**
+		@brief Add a value with an explicit timestamp
+
+		Performs in O(1) amortized constant time
+		@exception std::runtime_error if timestamp is older than the timestamp of the last value
+		@param val       - value to add
+		@param timestamp - time of the value, must not be older than the last value's
+	**/
+	void push_back(const TValue& val, time_point timestamp);
+
+	/**
+		@brief  Return the oldest unexpired value, without removing it from the list
+		@exception std::runtime_error if list is empty
+	**/
+	reference front();
+
+	/**
+		@brief  Return the newest value, without removing it from the list
+
+		Performs in O(1) constant time
+		@exception std::runtime_error if list is empty
+	**/
+	reference back();
+
+	/**
+		@brief  Timestamp of the newest value
+		@exception std::runtime_error if list is empty
+	**/
+	time_point backTimestamp() const;
+
+	/**
+		@brief Removes the oldest unexpired value and returns it
+		@exception std::runtime_error if list is empty
+	**/
+	value_type pop_front();
+
+	/**
+		@brief  Removes all values with a timestamp older than the given time
+
+		Performs in O(k) linear time, where k = the number of expired values, for finding the end of the expired prefix;
+		unlinking and freeing the prefix is O(1) for trivially destructible values.
+		@param  time - values stamped before this time are removed
+		@retval size_t number of values removed
+	**/
+	size_type expire_before(time_point time);
+
+	/**
+		@brief  Removes all values older than the time-to-live, does nothing if no time-to-live is set
+		@retval size_t number of values removed
+	**/
+	size_type expire();
+
+	/**
+		@brief Removes all values of the list, node memory is kept for reuse
+	**/
+	void clear();
+
+	duration timeToLive() const noexcept;
+
+	/**
+		@brief Set the age after which values expire lazily, duration::zero() turns lazy expiry off
+	**/
+	void setTimeToLive(duration timeToLive) noexcept;
+
+	iterator begin();
+	iterator end() noexcept;
+
+	/**
+		@brief Get string representation of list suitable for display
+	**/
+	std::string toString() const;
+
+private:
+	// forward declaration (implementation below)
+	struct Node;
+
+	Node* head;
+	Node* tail;
+
+	size_type count;
+
+	duration ttl;
+
+	// recycled nodes, linked through next
+	Node* freeList;
+	NodeChunks<Node> chunks;
+
+	// Take a node from the free list, allocating a new chunk if it is empty
+	Node* allocateNode();
+
+	// Expire lazily if a time-to-live is set
+	void expireIfTimed();
+};
+
+/**
+	@struct Node
+	@brief  Represents a node in the ExpiringList, the value is only constructed while the node is in the list
+**/
+template<typename TValue, typename TClock>
+struct ExpiringList<TValue, TClock>::Node
+{
+	Node* next;
+	time_point timestamp;
+	alignas(TValue) unsigned char storage[sizeof(TValue)];
+
+	TValue& value() noexcept
+	{
+		return *std::launder(reinterpret_cast<TValue*>(storage));
+	}
+
+	const TValue& value() const noexcept
+	{
+		return *std::launder(reinterpret_cast<const TValue*>(storage));
+	}
+};
+
+/**
+	@class  ExpiringList::iterator
+	@brief  Forward iterator over the values of an ExpiringList, oldest first
+**/
+template<typename TValue, typename TClock>
+class ExpiringList<TValue, TClock>::iterator
+{
+public:
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = TValue;
+	using difference_type = std::ptrdiff_t;
+	using pointer = value_type*;
+	using reference = value_type&;
+
+	constexpr iterator() noexcept
+		: current(nullptr)
+	{}
+
+	reference operator*() const
+	{
+		return current->value();
+	}
+
+	pointer operator->() const
+	{
+		return &current->value();
+	}
+
+	/**
+		@brief  Timestamp the current value was added with
+	**/
+	time_point timestamp() const
+	{
+		return current->timestamp;
+	}
+
+	iterator& operator++()
+	{
+		current = current->next;
+		return *this;
+	}
+
+	iterator operator++(int)
+	{
+		auto it = *this;
+		current = current->next;
+		return it;
+	}
+
+	bool operator==(const iterator& other) const
+	{
+		return current == other.current;
+	}
+
+	bool operator!=(const iterator& other) const
+	{
+		return !(*this == other);
+	}
+
+private:
+	Node* current;
+
+	constexpr explicit iterator(Node* current) noexcept
+		: current(current)
+	{}
+
+	friend class ExpiringList<TValue, TClock>;
+};
+
+template<typename TValue, typename TClock>
+inline ExpiringList<TValue, TClock>::ExpiringList() noexcept
+	: ExpiringList(duration::zero())
+{}
+
+template<typename TValue, typename TClock>
+inline ExpiringList<TValue, TClock>::ExpiringList(duration timeToLive) noexcept
+	: head(nullptr)
+	, tail(nullptr)
+	, count(0)
+	, ttl(timeToLive)
+	, freeList(nullptr)
+	, chunks()
+{}
+
+template<typename TValue, typename TClock>
+inline ExpiringList<TValue, TClock>::~ExpiringList()
+{
+	clear();
+}
+
+template<typename TValue, typename TClock>
+inline std::size_t ExpiringList<TValue, TClock>::size() const noexcept
+{
+	return count;
+}
+
+template<typename TValue, typename TClock>
+inline bool ExpiringList<TValue, TClock>::empty() const noexcept
+{
+	return head == nullptr;
+}
+
+template<typename TValue, typename TClock>
+inline void ExpiringList<TValue, TClock>::push_back(const TValue& val)
+{
+	push_back(val, TClock::now());
+}
+
+template<typename TValue, typename TClock>
+inline void ExpiringList<TValue, TClock>::push_back(const TValue& val, time_point timestamp)
+{
+	if (tail != nullptr && timestamp < tail->timestamp) throw std::runtime_error("timestamps must be non-decreasing");
+
+	auto node = allocateNode();
+	try
+	{
+		::new (static_cast<void*>(node->storage)) TValue(val);
+	}
+	catch (...)
+	{
+		node->next = freeList;
+		freeList = node;
+		throw;
+	}
+	node->next = nullptr;
+	node->timestamp = timestamp;
+
+	if (tail != nullptr)
+	{
+		tail->next = node;
+	}
+	else
+	{
+		head = node;
+	}
+	tail = node;
+	count++;
+}
+
+template<typename TValue, typename TClock>
+inline typename ExpiringList<TValue, TClock>::reference ExpiringList<TValue, TClock>::front()
+{
+	expireIfTimed();
+	if (head == nullptr) throw std::runtime_error("list is empty");
+	return head->value();
+}
+
+template<typename TValue, typename TClock>
+inline typename ExpiringList<TValue, TClock>::reference ExpiringList<TValue, TClock>::back()
+{
+	if (tail == nullptr) throw std::runtime_error("list is empty");
+	return tail->value();
+}
+
+template<typename TValue, typename TClock>
+inline typename ExpiringList<TValue, TClock>::time_point ExpiringList<TValue, TClock>::backTimestamp() const
+{
+	if (tail == nullptr) throw std::runtime_error("list is empty");
+	return tail->timestamp;
+}
+
+template<typename TValue, typename TClock>
+inline TValue ExpiringList<TValue, TClock>::pop_front()
+{
+	expireIfTimed();
+	if (head == nullptr) throw std::runtime_error("cannot remove from empty list");
+
+	auto node = head;
+	auto val = std::move(node->value());
+	node->value().~TValue();
+
+	head = node->next;
+	if (head == nullptr)
+	{
+		tail = nullptr;
+	}
+	count--;
+
+	node->next = freeList;
+	freeList = node;
+
+	return val;
+}
+
+template<typename TValue, typename TClock>
+inline std::size_t ExpiringList<TValue, TClock>::expire_before(time_point time)
+{
+	if (head == nullptr || !(head->timestamp < time))
+	{
+		return 0;
+	}
+
+	// find the last expired node, destroying values on the way if they need it
+	auto first = head;
+	auto last = head;
+	size_type expired = 1;
+	if constexpr (!std::is_trivially_destructible_v<TValue>)
+	{
+		last->value().~TValue();
+	}
+	while (last->next != nullptr && last->next->timestamp < time)
+	{
+		last = last->next;
+		expired++;
+		if constexpr (!std::is_trivially_destructible_v<TValue>)
+		{
+			last->value().~TValue();
+		}
+	}
+
+	// unlink the whole prefix at once
+	head = last->next;
+	if (head == nullptr)
+	{
+		tail = nullptr;
+	}
+	count -= expired;
+
+	// and free it as one batch
+	last->next = freeList;
+	freeList = first;
+
+	return expired;
+}
+
+template<typename TValue, typename TClock>
+inline std::size_t ExpiringList<TValue, TClock>::expire()
+{
+	if (ttl <= duration::zero())
+	{
+		return 0;
+	}
+	return expire_before(TClock::now() - ttl);
+}
+
+template<typename TValue, typename TClock>
+inline void ExpiringList<TValue, TClock>::clear()
+{
+	if (tail != nullptr)
+	{
+		expire_before(tail->timestamp);
+		// what is left all has the newest timestamp
+		if constexpr (!std::is_trivially_destructible_v<TValue>)
+		{
+			for (auto n = head; n != nullptr; n = n->next)
+			{
+				n->value().~TValue();
+			}
+		}
+		tail->next = freeList;
+		freeList = head;
+	}
+	head = nullptr;
+	tail = nullptr;
+	count = 0;
+}
+
+template<typename TValue, typename TClock>
+inline typename ExpiringList<TValue, TClock>::duration ExpiringList<TValue, TClock>::timeToLive() const noexcept
+{
+	return ttl;
+}
+
+template<typename TValue, typename TClock>
+inline void ExpiringList<TValue, TClock>::setTimeToLive(duration timeToLive) noexcept
+{
+	ttl = timeToLive;
+}
+
+template<typename TValue, typename TClock>
+inline typename ExpiringList<TValue, TClock>::iterator ExpiringList<TValue, TClock>::begin()
+{
+	expireIfTimed();
+	return iterator(head);
+}
+
+template<typename TValue, typename TClock>
+inline typename ExpiringList<TValue, TClock>::iterator ExpiringList<TValue, TClock>::end() noexcept
+{
+	return iterator(nullptr);
+}
+
+template<typename TValue, typename TClock>
+inline std::string ExpiringList<TValue, TClock>::toString() const
+{
+	std::stringstream ss;
+
+	auto n = head;
+	while (n != nullptr)
+	{
+		ss << '[' << n->value() << ']';
+		if (n->next != nullptr)
+		{
+			ss << "->";
+		}
+		n = n->next;
+	}
+
+	return ss.str();
+}
+
+template<typename TValue, typename TClock>
+inline typename ExpiringList<TValue, TClock>::Node* ExpiringList<TValue, TClock>::allocateNode()
+{
+	if (freeList == nullptr)
+	{
+		freeList = chunks.grow();
+	}
+
+	auto node = freeList;
+	freeList = node->next;
+	return node;
+}
+
+template<typename TValue, typename TClock>
+inline void ExpiringList<TValue, TClock>::expireIfTimed()
+{
+	if (ttl > duration::zero())
+	{
+		expire_before(TClock::now() - ttl);
+	}
+}
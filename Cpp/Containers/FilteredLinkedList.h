@@ -0,0 +1,378 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include "LinkedList.h"
+#include "CountingBloomFilter.h"
+
+/**
+
+	@class   FilteredLinkedList
+	@brief   LinkedList with a counting Bloom filter in front of contains()
+
+	@details ~ The filter is kept up to date on every push, pop and erase, so contains() answers definite misses
+			   in O(1) without walking the list; only possible hits (including false positives) walk the list.
+			   The filter is rebuilt from the list automatically when the list outgrows it, or after as many removals
+			   as the filter was sized for, since removals leave saturated counters and stale bits behind.
+			   Values are only exposed as const, changing a value in place would desynchronize the filter.
+	@tparam  TValue - type of list's values, must be equality comparable and hashable by THash
+	@tparam  THash  - hash function object for TValue
+
+**/
+template<typename TValue, typename THash = std::hash<TValue>>
+class FilteredLinkedList
+{
+public:
+	/**
+		@brief Construct an empty list
+		@param expectedValues - initial number of values the filter is sized for
+	**/
+	explicit FilteredLinkedList(std::size_t expectedValues = 1024);
+
+	using value_type = TValue;
+	using const_reference = const value_type&;
+	using size_type = std::size_t;
+	using const_iterator = typename LinkedList<TValue>::const_iterator;
+
+	/**
+		@brief  Returns size of the list
+
+		Performs in O(1) constant time
+		@retval size_t count of values in the list
+	**/
+	size_type size() const noexcept;
+
+	/**
+		@brief  Determines if the list is empty, i.e. it contains no values
+
+		Performs in O(1) constant time
+		@retval bool true if the list is empty, false if the list contains nodes
+	**/
+	bool empty() const noexcept;
+
+	/**
+		@brief Add an element to the front of the list
+
+		Performs in O(1) amortized constant time
+		@param val - value to add
+	**/
+	void push_front(const TValue& val);
+
+	/**
+		 @brief Add an element to the end of the list
+
+		 Performs in O(1) amortized constant time
+		 @param val - value to add
+	 **/
+	void push_back(const TValue& val);
+
+	/**
+		@brief  Return the value at the beginning of the list, without removing it from the list
+		@exception std::runtime_error if list is empty
+	**/
+	const_reference front() const;
+
+	/**
+		@brief  Return the value at the end of the list, without removing it from the list
+		@exception std::runtime_error if list is empty
+	**/
+	const_reference back() const;
+
+	/**
+		@brief Removes the value at the beginning of the list and returns it
+
+		Performs in O(1) amortized constant time
+		@exception std::runtime_error if list is empty
+	**/
+	value_type pop_front();
+
+	/**
+		@brief Removes the value at the end of the list and returns it
+
+		Performs in O(1) amortized constant time
+		@exception std::runtime_error if list is empty
+	**/
+	value_type pop_back();
+
+	/**
+		@brief Removes all elements of the list and resets the filter
+	**/
+	void clear();
+
+	/**
+		@brief  Determines if the list contains a value
+
+		Performs in O(1) constant time if the filter rules the value out, O(n) linear time otherwise
+		@param  val - value to search for
+		@retval bool true if the value was found
+	**/
+	bool contains(const TValue& val) const;
+
+	/**
+		@brief  Removes the first occurrence of a value
+
+		Performs in O(1) constant time if the filter rules the value out, O(n) linear time otherwise
+		@param  val - value to remove
+		@retval bool true if a value was removed
+	**/
+	bool erase(const TValue& val);
+
+	const_iterator begin() const noexcept;
+	const_iterator end() const noexcept;
+
+	/**
+		@brief Rebuild the filter from the values currently in the list, sized for twice the current count
+	**/
+	void rebuildFilter();
+
+	/**
+		@brief  Bytes used by the filter, in addition to the list's own nodes
+	**/
+	std::size_t filterMemoryUsage() const noexcept;
+
+	/**
+		@brief  Number of contains()/erase() calls the filter answered without walking the list
+	**/
+	std::size_t filteredLookups() const noexcept;
+
+	/**
+		@brief  Number of contains()/erase() calls the filter let through that then did not find the value
+	**/
+	std::size_t falsePositives() const noexcept;
+
+	/**
+		@brief  Measured false positive rate of the filter
+		@retval double falsePositives() / (falsePositives() + filteredLookups()), or 0 if there were no misses
+	**/
+	double falsePositiveRate() const noexcept;
+
+	/**
+		@brief  Number of times the filter was rebuilt
+	**/
+	std::size_t filterRebuilds() const noexcept;
+
+	/**
+		@brief Get string representation of list suitable for display
+	**/
+	std::string toString() const;
+
+private:
+	LinkedList<TValue> list;
+	CountingBloomFilter<TValue, THash> filter;
+
+	// the filter is never sized for fewer values than this
+	std::size_t minimumCapacity;
+	// removals since the filter was last rebuilt
+	std::size_t churn;
+	std::size_t rebuilds;
+
+	mutable std::size_t filteredCount;
+	mutable std::size_t falsePositiveCount;
+
+	// Record an added value, growing the filter if the list outgrew it
+	void onInsert(const TValue& val);
+	// Forget a removed value, rebuilding the filter after heavy churn
+	void onRemove(const TValue& val);
+};
+
+template<typename TValue, typename THash>
+inline FilteredLinkedList<TValue, THash>::FilteredLinkedList(std::size_t expectedValues)
+	: list()
+	, filter(expectedValues)
+	, minimumCapacity(filter.capacity())
+	, churn(0)
+	, rebuilds(0)
+	, filteredCount(0)
+	, falsePositiveCount(0)
+{}
+
+template<typename TValue, typename THash>
+inline std::size_t FilteredLinkedList<TValue, THash>::size() const noexcept
+{
+	return list.size();
+}
+
+template<typename TValue, typename THash>
+inline bool FilteredLinkedList<TValue, THash>::empty() const noexcept
+{
+	return list.empty();
+}
+
+template<typename TValue, typename THash>
+inline void FilteredLinkedList<TValue, THash>::push_front(const TValue& val)
+{
+	list.push_front(val);
+	onInsert(val);
+}
+
+template<typename TValue, typename THash>
+inline void FilteredLinkedList<TValue, THash>::push_back(const TValue& val)
+{
+	list.push_back(val);
+	onInsert(val);
+}
+
+template<typename TValue, typename THash>
+inline typename FilteredLinkedList<TValue, THash>::const_reference FilteredLinkedList<TValue, THash>::front() const
+{
+	return list.front();
+}
+
+template<typename TValue, typename THash>
+inline typename FilteredLinkedList<TValue, THash>::const_reference FilteredLinkedList<TValue, THash>::back() const
+{
+	return list.back();
+}
+
+template<typename TValue, typename THash>
+inline TValue FilteredLinkedList<TValue, THash>::pop_front()
+{
+	auto val = list.pop_front();
+	onRemove(val);
+	return val;
+}
+
+template<typename TValue, typename THash>
+inline TValue FilteredLinkedList<TValue, THash>::pop_back()
+{
+	auto val = list.pop_back();
+	onRemove(val);
+	return val;
+}
+
+template<typename TValue, typename THash>
+inline void FilteredLinkedList<TValue, THash>::clear()
+{
+	list.clear();
+	filter.reset(minimumCapacity);
+	churn = 0;
+}
+
+template<typename TValue, typename THash>
+inline bool FilteredLinkedList<TValue, THash>::contains(const TValue& val) const
+{
+	if (!filter.mayContain(val))
+	{
+		filteredCount++;
+		return false;
+	}
+
+	if (!list.contains(val))
+	{
+		falsePositiveCount++;
+		return false;
+	}
+	return true;
+}
+
+template<typename TValue, typename THash>
+inline bool FilteredLinkedList<TValue, THash>::erase(const TValue& val)
+{
+	if (!filter.mayContain(val))
+	{
+		filteredCount++;
+		return false;
+	}
+
+	auto it = list.find(val);
+	if (it == list.end())
+	{
+		falsePositiveCount++;
+		return false;
+	}
+
+	list.erase(it);
+	onRemove(val);
+	return true;
+}
+
+template<typename TValue, typename THash>
+inline typename FilteredLinkedList<TValue, THash>::const_iterator FilteredLinkedList<TValue, THash>::begin() const noexcept
+{
+	return list.begin();
+}
+
+template<typename TValue, typename THash>
+inline typename FilteredLinkedList<TValue, THash>::const_iterator FilteredLinkedList<TValue, THash>::end() const noexcept
+{
+	return list.end();
+}
+
+template<typename TValue, typename THash>
+inline void FilteredLinkedList<TValue, THash>::rebuildFilter()
+{
+	auto capacity = list.size() * 2;
+	filter.reset(capacity > minimumCapacity ? capacity : minimumCapacity);
+	for (auto it = list.begin(); it != list.end(); ++it)
+	{
+		filter.insert(*it);
+	}
+	churn = 0;
+	rebuilds++;
+}
+
+template<typename TValue, typename THash>
+inline std::size_t FilteredLinkedList<TValue, THash>::filterMemoryUsage() const noexcept
+{
+	return filter.memoryUsage();
+}
+
+template<typename TValue, typename THash>
+inline std::size_t FilteredLinkedList<TValue, THash>::filteredLookups() const noexcept
+{
+	return filteredCount;
+}
+
+template<typename TValue, typename THash>
+inline std::size_t FilteredLinkedList<TValue, THash>::falsePositives() const noexcept
+{
+	return falsePositiveCount;
+}
+
+template<typename TValue, typename THash>
+inline double FilteredLinkedList<TValue, THash>::falsePositiveRate() const noexcept
+{
+	auto misses = filteredCount + falsePositiveCount;
+	if (misses == 0)
+	{
+		return 0.0;
+	}
+	return static_cast<double>(falsePositiveCount) / static_cast<double>(misses);
+}
+
+template<typename TValue, typename THash>
+inline std::size_t FilteredLinkedList<TValue, THash>::filterRebuilds() const noexcept
+{
+	return rebuilds;
+}
+
+template<typename TValue, typename THash>
+inline std::string FilteredLinkedList<TValue, THash>::toString() const
+{
+	return list.toString();
+}
+
+template<typename TValue, typename THash>
+inline void FilteredLinkedList<TValue, THash>::onInsert(const TValue& val)
+{
+	if (list.size() > filter.capacity())
+	{
+		// rebuilding also re-adds val
+		rebuildFilter();
+	}
+	else
+	{
+		filter.insert(val);
+	}
+}
+
+template<typename TValue, typename THash>
+inline void FilteredLinkedList<TValue, THash>::onRemove(const TValue& val)
+{
+	filter.remove(val);
+	churn++;
+	if (churn > filter.capacity())
+	{
+		rebuildFilter();
+	}
+}
@@ -0,0 +1,564 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include "HashMix.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#	include <emmintrin.h>
+#	define LIBRARYCPP_FLATHASHMAP_SSE2 1
+#endif
+
+/**
+
+	@class   FlatHashMap
+	@brief   Open-addressing hash map with one metadata byte per slot, probed 16 slots at a time
+
+	@details ~ Keys and values live in one flat slot array, there is no allocation per entry.
+			   A parallel array holds one control byte per slot: empty, deleted, or 7 bits of the key's hash.
+			   Lookups compare the control bytes of a whole 16-slot group against the hash bits at once
+			   (one SSE2 compare where available, a scalar loop otherwise) and only compare keys for matching bytes,
+			   so misses usually finish after reading 16 bytes. Groups are probed triangularly.
+			   Shares it's interface with ChainedHashMap, see HashMap.h for choosing between them.
+	@tparam  TKey   - type of keys
+	@tparam  TValue - type of mapped values
+	@tparam  THash  - hash function object for TKey
+	@tparam  TEqual - equality function object for TKey
+
+**/
+template<typename TKey, typename TValue, typename THash = std::hash<TKey>, typename TEqual = std::equal_to<TKey>>
+class FlatHashMap
+{
+public:
+	/**
+		@brief Construct an empty map, no memory is allocated until the first insert
+	**/
+	FlatHashMap() noexcept;
+	~FlatHashMap();
+
+	FlatHashMap(const FlatHashMap&) = delete;
+	FlatHashMap& operator=(const FlatHashMap&) = delete;
+
+	FlatHashMap(FlatHashMap&& other) noexcept;
+	FlatHashMap& operator=(FlatHashMap&& other) noexcept;
+
+	using key_type = TKey;
+	using mapped_type = TValue;
+	using size_type = std::size_t;
+
+	/**
+		@brief  Returns number of keys in the map
+
+		Performs in O(1) constant time
+	**/
+	size_type size() const noexcept;
+
+	/**
+		@brief  Determines if the map is empty
+
+		Performs in O(1) constant time
+	**/
+	bool empty() const noexcept;
+
+	/**
+		@brief  Add a key and it's value if the key is not in the map yet
+
+		Performs in O(1) amortized constant time
+		@param  key   - key to add
+		@param  value - value to map the key to
+		@retval bool true if the key was added, false if it was already present (it's value is left unchanged)
+	**/
+	bool insert(const TKey& key, const TValue& value);
+
+	/**
+		@brief  Access the value mapped to a key, adding a default constructed value if the key is not in the map
+
+		Performs in O(1) amortized constant time
+	**/
+	TValue& operator[](const TKey& key);
+
+	/**
+		@brief  Access the value mapped to a key
+
+		Performs in O(1) average constant time
+		@exception std::runtime_error if the key is not in the map
+	**/
+	TValue& at(const TKey& key);
+	const TValue& at(const TKey& key) const;
+
+	/**
+		@brief  Look up the value mapped to a key
+
+		Performs in O(1) average constant time. The pointer is invalidated by the next insert.
+		@retval TValue* pointer to the mapped value, or nullptr if the key is not in the map
+	**/
+	TValue* find(const TKey& key);
+	const TValue* find(const TKey& key) const;
+
+	/**
+		@brief  Determines if the map contains a key
+
+		Performs in O(1) average constant time
+	**/
+	bool contains(const TKey& key) const;
+
+	/**
+		@brief  Remove a key and it's value
+
+		Performs in O(1) average constant time
+		@retval bool true if the key was removed, false if it was not in the map
+	**/
+	bool erase(const TKey& key);
+
+	/**
+		@brief Remove all keys, the slot arrays are kept for reuse
+	**/
+	void clear();
+
+	/**
+		@brief Prepare the map to hold a number of keys without rehashing
+		@param count - number of keys
+	**/
+	void reserve(size_type count);
+
+	/**
+		@brief Call a function with every key and value in the map, in unspecified order
+		@param func - callable as func(const TKey&, TValue&)
+	**/
+	template<typename TFunc>
+	void forEach(TFunc&& func);
+
+	/**
+		@brief  Bytes of heap memory held by the map
+	**/
+	std::size_t memoryUsage() const noexcept;
+
+private:
+	struct Slot
+	{
+		TKey key;
+		TValue value;
+	};
+
+	static constexpr std::size_t GroupSize = 16;
+
+	// control byte values, full slots hold 7 hash bits (0..127)
+	static constexpr std::int8_t Empty = -128;
+	static constexpr std::int8_t Deleted = -2;
+
+	static constexpr size_type npos = ~size_type(0);
+
+	std::int8_t* ctrl;
+	Slot* slots;
+
+	// number of slots, a power of two and a multiple of GroupSize (or 0)
+	size_type capacity;
+	size_type count;
+	size_type deleted;
+
+	THash hasher;
+	TEqual equal;
+
+	// Bit i set where ctrl[i] == h2, for the 16 control bytes of a group
+	static std::uint32_t match(const std::int8_t* group, std::int8_t h2) noexcept;
+	// Bit i set where ctrl[i] == Empty
+	static std::uint32_t matchEmpty(const std::int8_t* group) noexcept;
+	// Bit i set where ctrl[i] is Empty or Deleted
+	static std::uint32_t matchFree(const std::int8_t* group) noexcept;
+
+	// Hash a key, mixed so both the group index (high bits) and the control byte (low 7 bits) are usable
+	std::uint64_t hashOf(const TKey& key) const;
+
+	// Slot index holding a key, or npos
+	size_type findIndex(const TKey& key, std::uint64_t hash) const;
+
+	// Slot index for a key known to be absent, growing the table if needed
+	size_type prepareInsert(std::uint64_t hash);
+
+	// First empty or deleted slot on the hash's probe sequence
+	size_type findFree(std::uint64_t hash);
+
+	// Move all entries into a new table with the given number of slots
+	void rehash(size_type newCapacity);
+
+	// Destroy all entries and free both arrays
+	void destroy() noexcept;
+};
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline FlatHashMap<TKey, TValue, THash, TEqual>::FlatHashMap() noexcept
+	: ctrl(nullptr)
+	, slots(nullptr)
+	, capacity(0)
+	, count(0)
+	, deleted(0)
+{}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline FlatHashMap<TKey, TValue, THash, TEqual>::~FlatHashMap()
+{
+	destroy();
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline FlatHashMap<TKey, TValue, THash, TEqual>::FlatHashMap(FlatHashMap&& other) noexcept
+	: ctrl(std::exchange(other.ctrl, nullptr))
+	, slots(std::exchange(other.slots, nullptr))
+	, capacity(std::exchange(other.capacity, 0))
+	, count(std::exchange(other.count, 0))
+	, deleted(std::exchange(other.deleted, 0))
+	, hasher(std::move(other.hasher))
+	, equal(std::move(other.equal))
+{}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline FlatHashMap<TKey, TValue, THash, TEqual>& FlatHashMap<TKey, TValue, THash, TEqual>::operator=(FlatHashMap&& other) noexcept
+{
+	if (this != &other)
+	{
+		destroy();
+		ctrl = std::exchange(other.ctrl, nullptr);
+		slots = std::exchange(other.slots, nullptr);
+		capacity = std::exchange(other.capacity, 0);
+		count = std::exchange(other.count, 0);
+		deleted = std::exchange(other.deleted, 0);
+		hasher = std::move(other.hasher);
+		equal = std::move(other.equal);
+	}
+	return *this;
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline std::size_t FlatHashMap<TKey, TValue, THash, TEqual>::size() const noexcept
+{
+	return count;
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline bool FlatHashMap<TKey, TValue, THash, TEqual>::empty() const noexcept
+{
+	return count == 0;
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline bool FlatHashMap<TKey, TValue, THash, TEqual>::insert(const TKey& key, const TValue& value)
+{
+	auto hash = hashOf(key);
+	if (findIndex(key, hash) != npos)
+	{
+		return false;
+	}
+
+	auto index = prepareInsert(hash);
+	::new (static_cast<void*>(slots + index)) Slot{ key, value };
+	ctrl[index] = static_cast<std::int8_t>(hash & 0x7F);
+	count++;
+	return true;
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline TValue& FlatHashMap<TKey, TValue, THash, TEqual>::operator[](const TKey& key)
+{
+	auto hash = hashOf(key);
+	auto index = findIndex(key, hash);
+	if (index == npos)
+	{
+		index = prepareInsert(hash);
+		::new (static_cast<void*>(slots + index)) Slot{ key, TValue() };
+		ctrl[index] = static_cast<std::int8_t>(hash & 0x7F);
+		count++;
+	}
+	return slots[index].value;
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline TValue& FlatHashMap<TKey, TValue, THash, TEqual>::at(const TKey& key)
+{
+	auto index = findIndex(key, hashOf(key));
+	if (index == npos) throw std::runtime_error("key not found");
+	return slots[index].value;
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline const TValue& FlatHashMap<TKey, TValue, THash, TEqual>::at(const TKey& key) const
+{
+	auto index = findIndex(key, hashOf(key));
+	if (index == npos) throw std::runtime_error("key not found");
+	return slots[index].value;
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline TValue* FlatHashMap<TKey, TValue, THash, TEqual>::find(const TKey& key)
+{
+	auto index = findIndex(key, hashOf(key));
+	return index != npos ? &slots[index].value : nullptr;
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline const TValue* FlatHashMap<TKey, TValue, THash, TEqual>::find(const TKey& key) const
+{
+	auto index = findIndex(key, hashOf(key));
+	return index != npos ? &slots[index].value : nullptr;
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline bool FlatHashMap<TKey, TValue, THash, TEqual>::contains(const TKey& key) const
+{
+	return findIndex(key, hashOf(key)) != npos;
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline bool FlatHashMap<TKey, TValue, THash, TEqual>::erase(const TKey& key)
+{
+	auto index = findIndex(key, hashOf(key));
+	if (index == npos)
+	{
+		return false;
+	}
+
+	slots[index].~Slot();
+	count--;
+
+	// probes only continue past a group that was full, a group that still has an empty slot
+	// never was full since the last rehash, so the slot can become empty instead of a tombstone
+	if (matchEmpty(ctrl + (index & ~(GroupSize - 1))) != 0)
+	{
+		ctrl[index] = Empty;
+	}
+	else
+	{
+		ctrl[index] = Deleted;
+		deleted++;
+	}
+	return true;
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline void FlatHashMap<TKey, TValue, THash, TEqual>::clear()
+{
+	for (size_type i = 0; i < capacity; i++)
+	{
+		if (ctrl[i] >= 0)
+		{
+			slots[i].~Slot();
+		}
+	}
+	if (capacity > 0)
+	{
+		std::memset(ctrl, Empty, capacity);
+	}
+	count = 0;
+	deleted = 0;
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline void FlatHashMap<TKey, TValue, THash, TEqual>::reserve(size_type count)
+{
+	size_type newCapacity = GroupSize;
+	// keep the load at or below 7/8
+	while (newCapacity - newCapacity / 8 < count)
+	{
+		newCapacity *= 2;
+	}
+	if (newCapacity > capacity)
+	{
+		rehash(newCapacity);
+	}
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+template<typename TFunc>
+inline void FlatHashMap<TKey, TValue, THash, TEqual>::forEach(TFunc&& func)
+{
+	for (size_type i = 0; i < capacity; i++)
+	{
+		if (ctrl[i] >= 0)
+		{
+			func(static_cast<const TKey&>(slots[i].key), slots[i].value);
+		}
+	}
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline std::size_t FlatHashMap<TKey, TValue, THash, TEqual>::memoryUsage() const noexcept
+{
+	return capacity * (sizeof(Slot) + sizeof(std::int8_t));
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline std::uint32_t FlatHashMap<TKey, TValue, THash, TEqual>::match(const std::int8_t* group, std::int8_t h2) noexcept
+{
+#ifdef LIBRARYCPP_FLATHASHMAP_SSE2
+	auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+	return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(h2))));
+#else
+	std::uint32_t bits = 0;
+	for (std::size_t i = 0; i < GroupSize; i++)
+	{
+		bits |= std::uint32_t(group[i] == h2) << i;
+	}
+	return bits;
+#endif
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline std::uint32_t FlatHashMap<TKey, TValue, THash, TEqual>::matchEmpty(const std::int8_t* group) noexcept
+{
+	return match(group, Empty);
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline std::uint32_t FlatHashMap<TKey, TValue, THash, TEqual>::matchFree(const std::int8_t* group) noexcept
+{
+#ifdef LIBRARYCPP_FLATHASHMAP_SSE2
+	// Empty and Deleted are the only control bytes with the sign bit set
+	auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+	return static_cast<std::uint32_t>(_mm_movemask_epi8(bytes));
+#else
+	std::uint32_t bits = 0;
+	for (std::size_t i = 0; i < GroupSize; i++)
+	{
+		bits |= std::uint32_t(group[i] < 0) << i;
+	}
+	return bits;
+#endif
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline std::uint64_t FlatHashMap<TKey, TValue, THash, TEqual>::hashOf(const TKey& key) const
+{
+	return mixHash(hasher(key));
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline std::size_t FlatHashMap<TKey, TValue, THash, TEqual>::findIndex(const TKey& key, std::uint64_t hash) const
+{
+	if (capacity == 0)
+	{
+		return npos;
+	}
+
+	auto h2 = static_cast<std::int8_t>(hash & 0x7F);
+	auto groupMask = capacity / GroupSize - 1;
+	auto group = static_cast<size_type>(hash >> 7) & groupMask;
+	for (size_type step = 1; ; step++)
+	{
+		auto base = group * GroupSize;
+		for (auto bits = match(ctrl + base, h2); bits != 0; bits &= bits - 1)
+		{
+			auto index = base + std::countr_zero(bits);
+			if (equal(slots[index].key, key))
+			{
+				return index;
+			}
+		}
+
+		// the key would have been placed in this group's empty slot
+		if (matchEmpty(ctrl + base) != 0)
+		{
+			return npos;
+		}
+
+		// triangular probing visits every group of a power of two table
+		group = (group + step) & groupMask;
+	}
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline std::size_t FlatHashMap<TKey, TValue, THash, TEqual>::prepareInsert(std::uint64_t hash)
+{
+	if (capacity == 0)
+	{
+		rehash(GroupSize);
+	}
+	else if (count + deleted + 1 > capacity - capacity / 8)
+	{
+		// grow if mostly live entries, otherwise rehash in place to drop the tombstones
+		rehash(count + 1 > capacity / 2 ? capacity * 2 : capacity);
+	}
+	return findFree(hash);
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline std::size_t FlatHashMap<TKey, TValue, THash, TEqual>::findFree(std::uint64_t hash)
+{
+	auto groupMask = capacity / GroupSize - 1;
+	auto group = static_cast<size_type>(hash >> 7) & groupMask;
+	for (size_type step = 1; ; step++)
+	{
+		auto base = group * GroupSize;
+		auto bits = matchFree(ctrl + base);
+		if (bits != 0)
+		{
+			auto index = base + std::countr_zero(bits);
+			if (ctrl[index] == Deleted)
+			{
+				deleted--;
+			}
+			return index;
+		}
+		group = (group + step) & groupMask;
+	}
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline void FlatHashMap<TKey, TValue, THash, TEqual>::rehash(size_type newCapacity)
+{
+	// allocate both arrays before touching the map, so it is unchanged if either allocation throws
+	auto newCtrl = new std::int8_t[newCapacity];
+	Slot* newSlots;
+	try
+	{
+		newSlots = std::allocator<Slot>().allocate(newCapacity);
+	}
+	catch (...)
+	{
+		delete[] newCtrl;
+		throw;
+	}
+	std::memset(newCtrl, Empty, newCapacity);
+
+	auto oldCtrl = std::exchange(ctrl, newCtrl);
+	auto oldSlots = std::exchange(slots, newSlots);
+	auto oldCapacity = std::exchange(capacity, newCapacity);
+	deleted = 0;
+
+	for (size_type i = 0; i < oldCapacity; i++)
+	{
+		if (oldCtrl[i] >= 0)
+		{
+			auto hash = hashOf(oldSlots[i].key);
+			auto index = findFree(hash);
+			::new (static_cast<void*>(slots + index)) Slot{ std::move(oldSlots[i]) };
+			ctrl[index] = static_cast<std::int8_t>(hash & 0x7F);
+			oldSlots[i].~Slot();
+		}
+	}
+
+	if (oldCapacity > 0)
+	{
+		std::allocator<Slot>().deallocate(oldSlots, oldCapacity);
+		delete[] oldCtrl;
+	}
+}
+
+template<typename TKey, typename TValue, typename THash, typename TEqual>
+inline void FlatHashMap<TKey, TValue, THash, TEqual>::destroy() noexcept
+{
+	if (capacity > 0)
+	{
+		clear();
+		std::allocator<Slot>().deallocate(slots, capacity);
+		delete[] ctrl;
+	}
+	ctrl = nullptr;
+	slots = nullptr;
+	capacity = 0;
+}
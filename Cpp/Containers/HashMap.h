@@ -0,0 +1,34 @@
+#pragma once
+
+#include <functional>
+#include <type_traits>
+#include "ChainedHashMap.h"
+#include "FlatHashMap.h"
+
+/**
+	@enum  HashMapBackend
+	@brief Storage strategy of a HashMap
+**/
+enum class HashMapBackend
+{
+	// separate chaining, see ChainedHashMap; values stay at a stable address until erased
+	Chained,
+	// open addressing with group probed metadata, see FlatHashMap; faster and smaller, values move on rehash
+	Flat
+};
+
+/**
+	@brief  Hash map with a selectable backend
+
+	Both backends provide the same interface: size, empty, insert, operator[], at, find, contains, erase,
+	clear, reserve, forEach and memoryUsage.
+	@tparam TKey    - type of keys
+	@tparam TValue  - type of mapped values
+	@tparam Backend - storage strategy
+	@tparam THash   - hash function object for TKey
+	@tparam TEqual  - equality function object for TKey
+**/
+template<typename TKey, typename TValue, HashMapBackend Backend = HashMapBackend::Flat, typename THash = std::hash<TKey>, typename TEqual = std::equal_to<TKey>>
+using HashMap = std::conditional_t<Backend == HashMapBackend::Chained,
+	ChainedHashMap<TKey, TValue, THash, TEqual>,
+	FlatHashMap<TKey, TValue, THash, TEqual>>;
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+	@brief  Scramble a hash value so every output bit depends on every input bit (splitmix64 finalizer)
+
+	std::hash is the identity function for integers on the common standard libraries, which leaves
+	sequential keys with identical high bits; containers that slice the hash into parts mix it first.
+	@param  h - hash value to mix
+	@retval uint64_t mixed hash value
+**/
+constexpr std::uint64_t mixHash(std::uint64_t h) noexcept
+{
+	h ^= h >> 30;
+	h *= 0xbf58476d1ce4e5b9ULL;
+	h ^= h >> 27;
+	h *= 0x94d049bb133111ebULL;
+	h ^= h >> 31;
+	return h;
+}
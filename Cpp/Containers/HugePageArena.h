@@ -0,0 +1,328 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#if defined(__linux__)
+#	include <sys/mman.h>
+#	define LIBRARYCPP_HUGEPAGEARENA_MMAP 1
+#elif defined(_WIN32)
+// NOMINMAX only for windows.h itself, the includer's setting is left as it was
+#	ifndef NOMINMAX
+#		define NOMINMAX
+#		define LIBRARYCPP_HUGEPAGEARENA_NOMINMAX
+#	endif
+#	include <windows.h>
+#	ifdef LIBRARYCPP_HUGEPAGEARENA_NOMINMAX
+#		undef NOMINMAX
+#		undef LIBRARYCPP_HUGEPAGEARENA_NOMINMAX
+#	endif
+#	define LIBRARYCPP_HUGEPAGEARENA_VIRTUALALLOC 1
+#endif
+
+/**
+
+	@class   HugePageArena
+	@brief   Node memory carved from large chunks backed by huge pages where the system provides them
+
+	@details ~ Traversing hundreds of millions of nodes scattered over 4 KB pages misses the TLB on most steps; with the same
+			   nodes packed into 2 MB pages one TLB entry covers 512 times as much memory.
+			   Each chunk is first requested as explicit huge pages (mmap with MAP_HUGETLB on Linux, VirtualAlloc with
+			   MEM_LARGE_PAGES on Windows), which needs pages reserved by the administrator. If that fails it is
+			   mapped with normal pages and, on Linux, madvise(MADV_HUGEPAGE) asks for transparent huge pages.
+			   Elsewhere chunks come from operator new.
+			   allocate() serves requests from per-size free lists (sizes rounded up to 16 bytes) and then from
+			   the current chunk; deallocate() only puts memory on the free list. Chunks are returned to the system
+			   when the arena is destroyed. Not thread-safe: share an arena only between lists used by one thread.
+			   Lists opt in with LinkedList::setArena().
+
+**/
+class HugePageArena
+{
+public:
+	/**
+		@enum  PageMode
+		@brief Kind of pages backing a chunk of a HugePageArena
+	**/
+	enum class PageMode
+	{
+		// explicitly reserved huge pages (MAP_HUGETLB, MEM_LARGE_PAGES)
+		Huge,
+		// normal pages the kernel was asked to back with transparent huge pages (madvise(MADV_HUGEPAGE))
+		TransparentHuge,
+		// normal pages
+		Normal
+	};
+
+	// size of a huge page on x86-64 and ARM64 with 4 KB base pages
+	static constexpr std::size_t HugePageSize = std::size_t(2) << 20;
+
+	// largest request served, larger requests throw std::bad_alloc
+	static constexpr std::size_t MaxAllocation = 256;
+
+	/**
+		@brief Construct an arena, no memory is reserved until the first allocation
+		@param chunkSize - bytes reserved at a time, rounded up to a multiple of HugePageSize
+	**/
+	explicit HugePageArena(std::size_t chunkSize = 64 * HugePageSize) noexcept;
+
+	/**
+		@brief Returns all chunks to the system, memory handed out must no longer be used
+	**/
+	~HugePageArena();
+
+	HugePageArena(const HugePageArena&) = delete;
+	HugePageArena& operator=(const HugePageArena&) = delete;
+
+	/**
+		@brief  Allocate memory for one object
+
+		Performs in O(1) constant time, except when a new chunk has to be mapped
+		@exception std::bad_alloc if size exceeds MaxAllocation or no chunk can be mapped
+		@param  size      - bytes needed
+		@param  alignment - alignment needed, at most 16
+		@retval void* the memory
+	**/
+	void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+
+	/**
+		@brief Give back memory from allocate() for reuse by a later allocation of the same size
+
+		Performs in O(1) constant time
+		@param memory - memory returned by allocate()
+		@param size   - size passed to allocate()
+	**/
+	void deallocate(void* memory, std::size_t size) noexcept;
+
+	/**
+		@brief  Bytes reserved from the system
+	**/
+	std::size_t reservedBytes() const noexcept;
+
+	/**
+		@brief  Number of chunks, and how many of them are backed by explicit or transparent huge pages
+	**/
+	std::size_t chunkCount() const noexcept;
+	std::size_t hugeChunkCount() const noexcept;
+	std::size_t transparentHugeChunkCount() const noexcept;
+
+	/**
+		@brief  Page mode of the most recently mapped chunk, PageMode::Normal before the first allocation
+	**/
+	PageMode pageMode() const noexcept;
+
+private:
+	static constexpr std::size_t Granularity = 16;
+	static constexpr std::size_t SizeClasses = MaxAllocation / Granularity;
+
+	// chunk header, at the start of every chunk
+	struct Chunk
+	{
+		Chunk* next;
+		std::size_t size;
+		PageMode mode;
+	};
+
+	struct FreeSlot
+	{
+		FreeSlot* next;
+	};
+
+	const std::size_t chunkSize;
+
+	Chunk* chunks;
+	// unused part of the newest chunk
+	unsigned char* bump;
+	unsigned char* bumpEnd;
+
+	FreeSlot* freeLists[SizeClasses];
+
+	std::size_t reserved;
+	std::size_t chunksMapped;
+	std::size_t hugeChunks;
+	std::size_t transparentHugeChunks;
+
+	// Map a new chunk and make it the bump region
+	void addChunk();
+
+	// Map size bytes, trying huge pages first; mode receives what was obtained
+	static void* map(std::size_t size, PageMode& mode) noexcept;
+	static void unmap(void* memory, std::size_t size, PageMode mode) noexcept;
+};
+
+inline HugePageArena::HugePageArena(std::size_t chunkSize) noexcept
+	: chunkSize((chunkSize + HugePageSize - 1) / HugePageSize * HugePageSize)
+	, chunks(nullptr)
+	, bump(nullptr)
+	, bumpEnd(nullptr)
+	, freeLists()
+	, reserved(0)
+	, chunksMapped(0)
+	, hugeChunks(0)
+	, transparentHugeChunks(0)
+{}
+
+inline HugePageArena::~HugePageArena()
+{
+	while (chunks != nullptr)
+	{
+		auto next = chunks->next;
+		unmap(chunks, chunks->size, chunks->mode);
+		chunks = next;
+	}
+}
+
+inline void* HugePageArena::allocate(std::size_t size, std::size_t alignment)
+{
+	if (size == 0)
+	{
+		size = 1;
+	}
+	if (size > MaxAllocation || alignment > Granularity) throw std::bad_alloc();
+
+	auto sizeClass = (size - 1) / Granularity;
+	if (auto slot = freeLists[sizeClass])
+	{
+		freeLists[sizeClass] = slot->next;
+		return slot;
+	}
+
+	auto bytes = (sizeClass + 1) * Granularity;
+	if (static_cast<std::size_t>(bumpEnd - bump) < bytes)
+	{
+		addChunk();
+	}
+	auto memory = bump;
+	bump += bytes;
+	return memory;
+}
+
+inline void HugePageArena::deallocate(void* memory, std::size_t size) noexcept
+{
+	if (memory == nullptr)
+	{
+		return;
+	}
+	auto sizeClass = (size == 0 ? 0 : size - 1) / Granularity;
+	auto slot = static_cast<FreeSlot*>(memory);
+	slot->next = freeLists[sizeClass];
+	freeLists[sizeClass] = slot;
+}
+
+inline std::size_t HugePageArena::reservedBytes() const noexcept
+{
+	return reserved;
+}
+
+inline std::size_t HugePageArena::chunkCount() const noexcept
+{
+	return chunksMapped;
+}
+
+inline std::size_t HugePageArena::hugeChunkCount() const noexcept
+{
+	return hugeChunks;
+}
+
+inline std::size_t HugePageArena::transparentHugeChunkCount() const noexcept
+{
+	return transparentHugeChunks;
+}
+
+inline HugePageArena::PageMode HugePageArena::pageMode() const noexcept
+{
+	return chunks != nullptr ? chunks->mode : PageMode::Normal;
+}
+
+inline void HugePageArena::addChunk()
+{
+	PageMode mode;
+	auto memory = map(chunkSize, mode);
+	if (memory == nullptr) throw std::bad_alloc();
+
+	auto chunk = static_cast<Chunk*>(memory);
+	chunk->next = chunks;
+	chunk->size = chunkSize;
+	chunk->mode = mode;
+	chunks = chunk;
+
+	// the rest of the old chunk is abandoned, it is smaller than the largest allocation
+	bump = static_cast<unsigned char*>(memory) + (sizeof(Chunk) + Granularity - 1) / Granularity * Granularity;
+	bumpEnd = static_cast<unsigned char*>(memory) + chunkSize;
+
+	reserved += chunkSize;
+	chunksMapped++;
+	hugeChunks += mode == PageMode::Huge;
+	transparentHugeChunks += mode == PageMode::TransparentHuge;
+}
+
+inline void* HugePageArena::map(std::size_t size, PageMode& mode) noexcept
+{
+#if defined(LIBRARYCPP_HUGEPAGEARENA_MMAP)
+#	ifdef MAP_HUGETLB
+	auto memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+	if (memory != MAP_FAILED)
+	{
+		mode = PageMode::Huge;
+		return memory;
+	}
+#	endif
+
+	// no reserved huge pages: map normal pages aligned to a huge page, so transparent huge pages can back all of them
+	auto mapped = mmap(nullptr, size + HugePageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (mapped == MAP_FAILED)
+	{
+		return nullptr;
+	}
+	auto address = reinterpret_cast<std::uintptr_t>(mapped);
+	auto aligned = (address + HugePageSize - 1) / HugePageSize * HugePageSize;
+	if (aligned > address)
+	{
+		munmap(mapped, aligned - address);
+	}
+	munmap(reinterpret_cast<void*>(aligned + size), address + HugePageSize - aligned);
+	memory = reinterpret_cast<void*>(aligned);
+
+	mode = PageMode::Normal;
+#	ifdef MADV_HUGEPAGE
+	if (madvise(memory, size, MADV_HUGEPAGE) == 0)
+	{
+		mode = PageMode::TransparentHuge;
+	}
+#	endif
+	return memory;
+#elif defined(LIBRARYCPP_HUGEPAGEARENA_VIRTUALALLOC)
+	// large pages need the "Lock pages in memory" privilege and a size that is a multiple of the large page size
+	auto largePage = GetLargePageMinimum();
+	if (largePage != 0 && size % largePage == 0)
+	{
+		if (auto memory = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE))
+		{
+			mode = PageMode::Huge;
+			return memory;
+		}
+	}
+	mode = PageMode::Normal;
+	return VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+	mode = PageMode::Normal;
+	return ::operator new(size, std::align_val_t(HugePageSize), std::nothrow);
+#endif
+}
+
+inline void HugePageArena::unmap(void* memory, std::size_t size, PageMode mode) noexcept
+{
+#if defined(LIBRARYCPP_HUGEPAGEARENA_MMAP)
+	(void)mode;
+	munmap(memory, size);
+#elif defined(LIBRARYCPP_HUGEPAGEARENA_VIRTUALALLOC)
+	(void)size;
+	(void)mode;
+	VirtualFree(memory, 0, MEM_RELEASE);
+#else
+	(void)size;
+	(void)mode;
+	::operator delete(memory, std::align_val_t(HugePageSize));
+#endif
+}
@@ -2,10 +2,50 @@
 
 //#include "cpp_export.h"
 
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <istream>
+#include <iterator>
+#include <new>
+#include <ostream>
 #include <string>
 #include <sstream>
+#include <type_traits>
+#include <utility>
 #include "LinkedListIterator.h"
 #include "IStlContainer.h"
+#include "NodePool.h"
+#include "NodeReclaimer.h"
+#include "HugePageArena.h"
+#include "NodeCache.h"
+
+/**
+	@struct LinkedListNode
+	@brief  Represents a node in the LinkedList, shared by lists of every inline capacity so they share iterators
+	@tparam TValue - type of Node's values
+**/
+template<typename TValue>
+struct LinkedListNode
+{
+	constexpr explicit LinkedListNode(const TValue& val) noexcept
+		: next(nullptr)
+		, prev(nullptr)
+		, data(val)
+	{}
+
+	std::string toString() const;
+
+private:
+	LinkedListNode* next;
+	LinkedListNode* prev;
+	TValue data;
+
+	template<typename, std::size_t> friend class LinkedList;
+	friend class LinkedListIterator<TValue>;
+	friend class ConstLinkedListIterator<TValue>;
+};
 
 /**
 
@@ -13,10 +53,19 @@
 	@brief   Doubley-linked list
 
 	@details ~ Follows STL container and iterator conventions. Compatible with range-based for loop and other methods in the <algorithm> header.
-	@tparam  TValue - type of list's values
+			   Everything but serialization and toString() can be used in constant expressions, so lists can be built and
+			   sorted at compile time and frozen into an array with toArray().
+			   Lists of trivially copyable values allocate their nodes from a NodePool owned by the list: nodes carry no
+			   heap header, sit next to each other, and clear() frees the pool's blocks without visiting the nodes.
+			   Copies and range inserts of such lists fill one contiguous run of pool nodes with memcpy, and the lists
+			   can be serialized as raw bytes.
+			   With InlineN > 0 the first InlineN nodes live inside the list object itself and only further nodes are
+			   allocated, so short lists need no allocation at all. Moving such a list moves it's values one by one.
+	@tparam  TValue  - type of list's values
+	@tparam  InlineN - number of nodes stored inside the list object, 0 allocates every node
 
 **/
-template<typename TValue>
+template<typename TValue, std::size_t InlineN = 0>
 class LinkedList// : IStlContainer<TValue>
 {
 public:
@@ -24,7 +73,24 @@ public:
 		@brief Construct an empty list
 	**/
 	constexpr LinkedList() noexcept;
-	~LinkedList();
+	constexpr ~LinkedList();
+
+	/**
+		@brief Construct a list holding copies of another list's values
+
+		Performs in O(n) linear time, where n = the number of values in the other list
+	**/
+	constexpr LinkedList(const LinkedList& other);
+
+	/**
+		@brief Construct a list taking over another list's nodes, the other list is left empty
+
+		Performs in O(1) constant time. With InlineN > 0 the values are copied instead, in O(n) linear time.
+	**/
+	constexpr LinkedList(LinkedList&& other) noexcept(InlineN == 0);
+
+	constexpr LinkedList& operator=(const LinkedList& other);
+	constexpr LinkedList& operator=(LinkedList&& other) noexcept(InlineN == 0);
 
 	using value_type = TValue;
 	using pointer = value_type*;
@@ -45,7 +111,7 @@ public:
 		Performs in O(1) constant time
 		@retval size_t count of values in the list
 	**/
-	size_type size() const noexcept;
+	constexpr size_type size() const noexcept;
 
 	/**
 		@brief  Determines if the list is empty, i.e. it contains no values
@@ -53,7 +119,7 @@ public:
 		Performs in O(1) constant time
 		@retval bool true if the list is empty, false if the list contains nodes
 	**/
-	bool empty() const noexcept;
+	constexpr bool empty() const noexcept;
 
 	/**
 		@brief Add an element to the front of the list
@@ -61,8 +127,8 @@ public:
 		Performs in O(1) constant time
 		@param val - value to add
 	**/
-	void push_front(const TValue& val);
-	void push_front(TValue&& val);
+	constexpr void push_front(const TValue& val);
+	constexpr void push_front(TValue&& val);
 
 	/**
 		 @brief Add an element to the end of the list
@@ -70,8 +136,8 @@ public:
 		 Performs in O(1) constant time
 		 @param val - value to add
 	 **/
-	void push_back(const TValue& val);
-	void push_back(TValue&& val);
+	constexpr void push_back(const TValue& val);
+	constexpr void push_back(TValue&& val);
 
 	/**
 		@brief  Return the value at the beginning of the list, without removing it from the list
@@ -81,8 +147,8 @@ public:
 		@exception std::runtime_error if list is empty
 		@retval TValue value at the beginning of the list
 	**/
-	reference front();
-	const_reference front() const;
+	constexpr reference front();
+	constexpr const_reference front() const;
 
 	/**
 		@brief  Return the value at the end of the list, without removing it from the list
@@ -91,8 +157,8 @@ public:
 		@exception std::runtime_error if list is empty
 		@retval TValue value at the end of the list
 	**/
-	reference back();
-	const_reference back() const;
+	constexpr reference back();
+	constexpr const_reference back() const;
 
 	/**
 		@brief Removes the value at the beginning of the list and returns it
@@ -101,7 +167,7 @@ public:
 		@exception std::runtime_error if list is empty
 		@retval TValue value at the beginning of the list
 	**/
-	value_type pop_front();
+	constexpr value_type pop_front();
 
 	/**
 		@brief Removes the value at the end of the list and returns it
@@ -110,26 +176,130 @@ public:
 		@exception std::runtime_error if list is empty
 		@retval TValue value at the end of the list
 	**/
-	value_type pop_back();
+	constexpr value_type pop_back();
 
 	/**
 		@brief Removes all elements of the list
 
+		Performs in O(n) linear time, where n = the number of values in the list.
+		With a reclaimer set, the node chain is handed to it instead and this performs in O(1) constant time.
+		With InlineN > 0 the chain is still walked once to take the inline nodes out of it.
+	**/
+	constexpr void clear();
+
+	/**
+		@brief Hand the nodes of cleared or destroyed lists to a reclaimer instead of freeing them immediately
+
+		With ReclaimMode::Incremental, every later push and pop of this list also calls reclaimer->collect(),
+		freeing a bounded number of previously retired nodes.
+		Lists of trivially copyable values free their node blocks directly and do not retire nodes.
+		@param reclaimer - reclaimer to use, must outlive the list; nullptr frees nodes immediately (the default)
+	**/
+	constexpr void setReclaimer(NodeReclaimer* reclaimer) noexcept;
+
+	/**
+		@brief Allocate the nodes of this list from a huge-page-backed arena
+
+		Long lists traversed end to end spend much of their time on TLB misses; nodes packed into huge pages avoid most of them.
+		Nodes beyond the inline capacity come from the arena instead of the node pool or the heap, and clear() gives them
+		back to the arena one by one, without handing them to a reclaimer.
+		@exception std::runtime_error if the list is not empty
+		@param arena - arena to use, must outlive the list; nullptr allocates nodes as usual (the default)
+	**/
+	constexpr void setArena(HugePageArena* arena);
+
+	/**
+		@brief  Search the list for the first node holding a value
+
 		Performs in O(n) linear time, where n = the number of values in the list
+		@param  val - value to search for
+		@retval iterator pointing at the found value, or end() if the value is not in the list
 	**/
-	void clear();
+	constexpr iterator find(const TValue& val);
 
-	iterator begin() noexcept;
-	iterator end() noexcept;
+	/**
+		@brief  Determines if the list contains a value
 
-	iterator rbegin() noexcept;
-	iterator rend() noexcept;
+		Performs in O(n) linear time, where n = the number of values in the list
+		@param  val - value to search for
+		@retval bool true if the value was found
+	**/
+	constexpr bool contains(const TValue& val) const;
 
-	const_iterator begin() const noexcept;
-	const_iterator end() const noexcept;
+	/**
+		@brief  Removes the value the iterator points at
 
-	const_iterator cbegin() const noexcept;
-	const_iterator cend() const noexcept;
+		Performs in O(1) constant time
+		@param  pos - valid, dereferenceable iterator into this list
+		@retval iterator pointing at the value following the removed one
+	**/
+	constexpr iterator erase(iterator pos);
+
+	/**
+		@brief  Insert copies of a range of values BEFORE the given position
+
+		The new nodes are built as a separate chain and linked into the list with a single splice. Trivially
+		copyable values from a forward range of TValue get one contiguous run of pool nodes and are memcpy'd in.
+		Performs in O(k) linear time, where k = the number of values inserted
+		@param  pos   - position to insert before, end() appends
+		@param  first - beginning of the range of values
+		@param  last  - end of the range of values
+		@retval iterator pointing at the first inserted value, or pos if the range is empty
+	**/
+	template<typename TInputIt>
+	constexpr iterator insert(iterator pos, TInputIt first, TInputIt last);
+
+	/**
+		@brief Sort the list's values, equal values keep their order
+
+		Merge sort relinking the existing nodes, no value is copied or moved.
+		Performs in O(n log n) time, where n = the number of values in the list
+		@param compare - strict weak ordering, std::less by default
+	**/
+	template<typename TCompare = std::less<>>
+	constexpr void sort(TCompare compare = TCompare());
+
+	/**
+		@brief  Copy the list's values into an array
+
+		Meant for freezing a list built in a constant expression into data that outlives the evaluation:
+		constexpr auto table = [] { LinkedList<int> list; ...; return list.toArray<5>(); }();
+		@exception std::runtime_error if the list does not hold exactly N values
+		@tparam N - number of values in the list
+		@retval std::array holding the values in list order
+	**/
+	template<std::size_t N>
+	constexpr std::array<TValue, N> toArray() const;
+
+	/**
+		@brief Write the list's values to a stream as raw bytes
+
+		Writes the count of values followed by the values' object representations, copied into the
+		stream in large chunks. The format is only readable by deserialize() on the same platform.
+		@exception std::runtime_error if writing fails
+		@param out - stream to write to, should be opened in binary mode
+	**/
+	void serialize(std::ostream& out) const requires std::is_trivially_copyable_v<TValue>;
+
+	/**
+		@brief  Read a list written by serialize()
+		@exception std::runtime_error if reading fails
+		@param  in - stream to read from, should be opened in binary mode
+		@retval LinkedList holding the values read
+	**/
+	static LinkedList deserialize(std::istream& in) requires std::is_trivially_copyable_v<TValue>;
+
+	constexpr iterator begin() noexcept;
+	constexpr iterator end() noexcept;
+
+	constexpr iterator rbegin() noexcept;
+	constexpr iterator rend() noexcept;
+
+	constexpr const_iterator begin() const noexcept;
+	constexpr const_iterator end() const noexcept;
+
+	constexpr const_iterator cbegin() const noexcept;
+	constexpr const_iterator cend() const noexcept;
 
 	/**
 		@brief Get string representation of list suitable for display
@@ -140,150 +310,225 @@ public:
 	virtual std::string toString() const;
 
 private:
-	// forward declaration (implementation below)
-	struct Node;
+	using Node = LinkedListNode<TValue>;
 
 	Node* head;
 	Node* tail;
 
 	int count;
 
-protected:
-	// Add the specified value AFTER the given node
-	void addAfter(Node* node, const TValue& val);
-	// Add the specified value BEFORE the given node
-	void addBefore(Node* node, const TValue& val);
+	NodeReclaimer* reclaimer;
+	HugePageArena* arena;
 
-	// Remove the given node (and free it's memory)
-	TValue removeNode(Node* node);
+	// nodes of trivially copyable values come from a pool, they need no destructor walk on clear()
+	static constexpr bool pooled = std::is_trivially_copyable_v<TValue>;
 
-};
+	struct NoPool
+	{
+	};
 
-/**
-	@struct Node
-	@brief  Represents a node in the LinkedList
-	@tparam TValue - type of Node's values
-**/
-template<typename TValue>
-struct LinkedList<TValue>::Node
-{
-	constexpr explicit Node(const TValue& val) noexcept
-		: next(nullptr)
-		, prev(nullptr)
-		, data(val)
-	{}
+	[[no_unique_address]] std::conditional_t<pooled, NodePool<Node>, NoPool> pool;
 
-	~Node()
+	// node slots inside the list object, used before any node is allocated
+	struct InlineNodes
 	{
-		delete next;
-		next = nullptr;
-	}
+		union Slot
+		{
+			Slot* nextFree;
+			alignas(Node) unsigned char storage[sizeof(Node)];
+		};
+
+		constexpr InlineNodes() noexcept
+			: freeList(nullptr)
+			, used(0)
+		{}
+
+		Slot slots[InlineN];
+		// released slots, ready for reuse
+		Slot* freeList;
+		// slots [0, used) were handed out at least once
+		std::size_t used;
+	};
+
+	struct NoInlineNodes
+	{
+	};
 
-	std::string toString() const;
+	[[no_unique_address]] std::conditional_t<(InlineN > 0), InlineNodes, NoInlineNodes> inlineNodes;
 
-private:
-	TValue data;
-	Node* next;
-	Node* prev;
+	// Allocate and construct a node holding a copy of val
+	constexpr Node* createNode(const TValue& val);
+	// Destroy and free a node
+	constexpr void destroyNode(Node* node) noexcept;
+	// Destroy and free every node of a chain linked through next
+	constexpr void destroyChain(Node* first) noexcept;
+	// Determines if the node lives in the list object's inline slots
+	constexpr bool isInline(const Node* node) const noexcept;
+
+	// Take over the nodes of another list, which is left empty; this list must be empty
+	constexpr void takeNodes(LinkedList& other);
+	// Destroy the inline nodes and return the remaining, allocated nodes as a chain linked through next
+	constexpr Node* detachAllocatedNodes() noexcept;
+
+	// Link the chain of nodes first..last BEFORE the given node (nullptr = at the end)
+	constexpr void linkChain(Node* node, Node* first, Node* last) noexcept;
+
+	// Sort a chain of n nodes linked through next, prev links are left stale; returns the new first node
+	template<typename TCompare>
+	static constexpr Node* mergeSort(Node* first, size_type n, TCompare& compare);
+
+	// Frees up to budget nodes of a chain retired to a NodeReclaimer
+	static std::size_t releaseChain(void*& chain, std::size_t budget);
+
+protected:
+	// Add the specified value AFTER the given node
+	constexpr void addAfter(Node* node, const TValue& val);
+	// Add the specified value BEFORE the given node
+	constexpr void addBefore(Node* node, const TValue& val);
+
+	// Remove the given node (and free it's memory)
+	constexpr TValue removeNode(Node* node);
 
-	friend class LinkedList<TValue>;
-	friend class LinkedList<TValue>::iterator;
 };
 
-template<typename TValue>
-inline constexpr LinkedList<TValue>::LinkedList() noexcept
+template<typename TValue, std::size_t InlineN>
+inline constexpr LinkedList<TValue, InlineN>::LinkedList() noexcept
 	: head(nullptr)
 	, tail(nullptr)
 	, count(0)
+	, reclaimer(nullptr)
+	, arena(nullptr)
+	, pool()
+	, inlineNodes()
 {}
 
-template<typename TValue>
-inline LinkedList<TValue>::~LinkedList()
+template<typename TValue, std::size_t InlineN>
+inline constexpr LinkedList<TValue, InlineN>::LinkedList(const LinkedList& other)
+	: LinkedList()
+{
+	insert(end(), other.begin(), other.end());
+}
+
+template<typename TValue, std::size_t InlineN>
+inline constexpr LinkedList<TValue, InlineN>::LinkedList(LinkedList&& other) noexcept(InlineN == 0)
+	: LinkedList()
+{
+	reclaimer = other.reclaimer;
+	arena = other.arena;
+	takeNodes(other);
+}
+
+template<typename TValue, std::size_t InlineN>
+inline constexpr LinkedList<TValue, InlineN>& LinkedList<TValue, InlineN>::operator=(const LinkedList& other)
+{
+	if (this != &other)
+	{
+		clear();
+		insert(end(), other.begin(), other.end());
+	}
+	return *this;
+}
+
+template<typename TValue, std::size_t InlineN>
+inline constexpr LinkedList<TValue, InlineN>& LinkedList<TValue, InlineN>::operator=(LinkedList&& other) noexcept(InlineN == 0)
+{
+	if (this != &other)
+	{
+		clear();
+		reclaimer = other.reclaimer;
+		arena = other.arena;
+		takeNodes(other);
+	}
+	return *this;
+}
+
+template<typename TValue, std::size_t InlineN>
+inline constexpr LinkedList<TValue, InlineN>::~LinkedList()
 {
 	clear();
 }
 
-template<typename TValue>
-inline std::size_t LinkedList<TValue>::size() const noexcept
+template<typename TValue, std::size_t InlineN>
+inline constexpr std::size_t LinkedList<TValue, InlineN>::size() const noexcept
 {
 	return count;
 }
 
-template<typename TValue>
-inline bool LinkedList<TValue>::empty() const noexcept
+template<typename TValue, std::size_t InlineN>
+inline constexpr bool LinkedList<TValue, InlineN>::empty() const noexcept
 {
 	return head == nullptr;
 }
 
-template<typename TValue>
-inline void LinkedList<TValue>::push_front(const TValue& val)
+template<typename TValue, std::size_t InlineN>
+inline constexpr void LinkedList<TValue, InlineN>::push_front(const TValue& val)
 {
 	addBefore(head, val);
 }
 
-template<typename TValue>
-inline void LinkedList<TValue>::push_front(TValue&& val)
+template<typename TValue, std::size_t InlineN>
+inline constexpr void LinkedList<TValue, InlineN>::push_front(TValue&& val)
 {
 	addBefore(head, std::move(val));
 }
 
-template<typename TValue>
-inline void LinkedList<TValue>::push_back(const TValue& val)
+template<typename TValue, std::size_t InlineN>
+inline constexpr void LinkedList<TValue, InlineN>::push_back(const TValue& val)
 {
 	addAfter(tail, val);
 }
 
-template<typename TValue>
-inline void LinkedList<TValue>::push_back(TValue&& val)
+template<typename TValue, std::size_t InlineN>
+inline constexpr void LinkedList<TValue, InlineN>::push_back(TValue&& val)
 {
 	addAfter(tail, std::move(val));
 	//push_back(val);
 }
 
-template<typename TValue>
-inline TValue LinkedList<TValue>::pop_front()
+template<typename TValue, std::size_t InlineN>
+inline constexpr TValue LinkedList<TValue, InlineN>::pop_front()
 {
 	return removeNode(head);
 }
 
-template<typename TValue>
-inline TValue LinkedList<TValue>::pop_back()
+template<typename TValue, std::size_t InlineN>
+inline constexpr TValue LinkedList<TValue, InlineN>::pop_back()
 {
 	return removeNode(tail);
 }
 
-template<typename TValue>
-inline  LinkedList<TValue>::reference LinkedList<TValue>::front()
+template<typename TValue, std::size_t InlineN>
+inline constexpr LinkedList<TValue, InlineN>::reference LinkedList<TValue, InlineN>::front()
 {
 	if (head == nullptr) throw std::runtime_error("list is empty");
 	return head->data;
 }
 
-template<typename TValue>
-inline LinkedList<TValue>::const_reference LinkedList<TValue>::front() const
+template<typename TValue, std::size_t InlineN>
+inline constexpr LinkedList<TValue, InlineN>::const_reference LinkedList<TValue, InlineN>::front() const
 {
 	if (head == nullptr) throw std::runtime_error("list is empty");
 	return head->data;
 }
 
-template<typename TValue>
-inline LinkedList<TValue>::reference LinkedList<TValue>::back()
+template<typename TValue, std::size_t InlineN>
+inline constexpr LinkedList<TValue, InlineN>::reference LinkedList<TValue, InlineN>::back()
 {
 	if (tail == nullptr) throw std::runtime_error("list is empty");
 	return tail->data;
 }
 
-template<typename TValue>
-inline LinkedList<TValue>::const_reference LinkedList<TValue>::back() const
+template<typename TValue, std::size_t InlineN>
+inline constexpr LinkedList<TValue, InlineN>::const_reference LinkedList<TValue, InlineN>::back() const
 {
 	if (tail == nullptr) throw std::runtime_error("list is empty");
 	return tail->data;
 }
 
-template<typename TValue>
-inline void LinkedList<TValue>::addAfter(Node* node, const TValue& val)
+template<typename TValue, std::size_t InlineN>
+inline constexpr void LinkedList<TValue, InlineN>::addAfter(Node* node, const TValue& val)
 {
-	auto newNode = new Node(val);
+	auto newNode = createNode(val);
 	if (node != nullptr)
 	{
 		newNode->prev = node;
@@ -307,12 +552,17 @@ inline void LinkedList<TValue>::addAfter(Node* node, const TValue& val)
 		tail = newNode;
 	}
 	count++;
+
+	if (reclaimer != nullptr)
+	{
+		reclaimer->collect();
+	}
 }
 
-template<typename TValue>
-inline void LinkedList<TValue>::addBefore(Node* node, const TValue& val)
+template<typename TValue, std::size_t InlineN>
+inline constexpr void LinkedList<TValue, InlineN>::addBefore(Node* node, const TValue& val)
 {
-	auto newNode = new Node(val);
+	auto newNode = createNode(val);
 	if (node != nullptr)
 	{
 		newNode->next = node;
@@ -336,10 +586,15 @@ inline void LinkedList<TValue>::addBefore(Node* node, const TValue& val)
 		tail = newNode;
 	}
 	count++;
+
+	if (reclaimer != nullptr)
+	{
+		reclaimer->collect();
+	}
 }
 
-template<typename TValue>
-inline TValue LinkedList<TValue>::removeNode(Node* node)
+template<typename TValue, std::size_t InlineN>
+inline constexpr TValue LinkedList<TValue, InlineN>::removeNode(Node* node)
 {
 	if (head == nullptr) throw std::runtime_error("cannot remove from empty list");
 
@@ -365,79 +620,554 @@ inline TValue LinkedList<TValue>::removeNode(Node* node)
 		head = node->next;
 	}
 
-	//// set next = nullptr so we don't delete the rest of the list after the node we are removing
-	node->next = nullptr;
-	node->prev = nullptr;
-	delete node;
+	destroyNode(node);
 
 	count--;
 
+	if (reclaimer != nullptr)
+	{
+		reclaimer->collect();
+	}
+
 	return val;
 }
 
-template<typename TValue>
-inline void LinkedList<TValue>::clear()
+template<typename TValue, std::size_t InlineN>
+inline constexpr void LinkedList<TValue, InlineN>::clear()
 {
-	//while (!empty())
-	//{
-	//	removeNode(tail);
-	//}
-	delete head;
+	if (std::is_constant_evaluated())
+	{
+		// nodes of constant expressions never come from the pool or the inline slots, see createNode()
+		destroyChain(head);
+	}
+	else if (arena != nullptr)
+	{
+		destroyChain(head);
+	}
+	else if constexpr (pooled)
+	{
+		// values are trivially destructible, the nodes can be dropped with their blocks
+		pool.release();
+		if constexpr (InlineN > 0)
+		{
+			inlineNodes.freeList = nullptr;
+			inlineNodes.used = 0;
+		}
+	}
+	else if (reclaimer != nullptr)
+	{
+		// detach the whole chain, the reclaimer frees it later; inline nodes cannot outlive the list, they go now
+		reclaimer->retire(detachAllocatedNodes(), &LinkedList<TValue, InlineN>::releaseChain);
+	}
+	else
+	{
+		destroyChain(head);
+	}
 	head = nullptr;
 	tail = nullptr;
 	count = 0;
 }
 
-template<typename TValue>
-inline LinkedList<TValue>::iterator LinkedList<TValue>::begin() noexcept
+template<typename TValue, std::size_t InlineN>
+inline constexpr void LinkedList<TValue, InlineN>::setReclaimer(NodeReclaimer* reclaimer) noexcept
+{
+	this->reclaimer = reclaimer;
+}
+
+template<typename TValue, std::size_t InlineN>
+inline constexpr void LinkedList<TValue, InlineN>::setArena(HugePageArena* arena)
+{
+	if (!empty()) throw std::runtime_error("cannot change the arena of a non-empty list");
+	this->arena = arena;
+}
+
+template<typename TValue, std::size_t InlineN>
+template<typename TInputIt>
+inline constexpr LinkedList<TValue, InlineN>::iterator LinkedList<TValue, InlineN>::insert(iterator pos, TInputIt first, TInputIt last)
+{
+	if (first == last)
+	{
+		return pos;
+	}
+
+	if constexpr (pooled && InlineN == 0 && std::forward_iterator<TInputIt>
+		&& std::is_lvalue_reference_v<std::iter_reference_t<TInputIt>> && std::is_same_v<std::iter_value_t<TInputIt>, TValue>)
+	{
+		if (!std::is_constant_evaluated() && arena == nullptr)
+		{
+			// copying trivially copyable values cannot throw: take one run of pool slots, link it in order and memcpy the values in
+			auto n = static_cast<std::size_t>(std::distance(first, last));
+			auto run = pool.allocateRun(n);
+			for (std::size_t i = 0; i < n; i++, ++first)
+			{
+				auto node = run + i;
+				node->prev = i > 0 ? node - 1 : nullptr;
+				node->next = i + 1 < n ? node + 1 : nullptr;
+				std::memcpy(&node->data, &*first, sizeof(TValue));
+			}
+			linkChain(pos.current, run, run + n - 1);
+			count += static_cast<int>(n);
+			return iterator(run);
+		}
+	}
+
+	// build the new nodes as a separate chain, the list is untouched if a copy throws
+	auto chainHead = createNode(*first);
+	auto chainTail = chainHead;
+	int added = 1;
+	try
+	{
+		for (++first; first != last; ++first)
+		{
+			auto newNode = createNode(*first);
+			newNode->prev = chainTail;
+			chainTail->next = newNode;
+			chainTail = newNode;
+			added++;
+		}
+	}
+	catch (...)
+	{
+		while (chainHead != nullptr)
+		{
+			auto next = chainHead->next;
+			destroyNode(chainHead);
+			chainHead = next;
+		}
+		throw;
+	}
+
+	linkChain(pos.current, chainHead, chainTail);
+	count += added;
+	return iterator(chainHead);
+}
+
+template<typename TValue, std::size_t InlineN>
+template<typename TCompare>
+inline constexpr void LinkedList<TValue, InlineN>::sort(TCompare compare)
+{
+	if (count < 2)
+	{
+		return;
+	}
+
+	head = mergeSort(head, count, compare);
+
+	// restore the prev links and the tail
+	Node* prev = nullptr;
+	for (auto n = head; n != nullptr; n = n->next)
+	{
+		n->prev = prev;
+		prev = n;
+	}
+	tail = prev;
+}
+
+template<typename TValue, std::size_t InlineN>
+template<std::size_t N>
+inline constexpr std::array<TValue, N> LinkedList<TValue, InlineN>::toArray() const
+{
+	if (size() != N) throw std::runtime_error("list size does not match array size");
+
+	std::array<TValue, N> values{};
+	std::size_t i = 0;
+	for (auto n = head; n != nullptr; n = n->next)
+	{
+		values[i++] = n->data;
+	}
+	return values;
+}
+
+template<typename TValue, std::size_t InlineN>
+inline void LinkedList<TValue, InlineN>::serialize(std::ostream& out) const requires std::is_trivially_copyable_v<TValue>
+{
+	auto size = static_cast<std::uint64_t>(count);
+	out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+
+	// gather values into a buffer with memcpy and write it in large chunks instead of value by value
+	constexpr std::size_t chunkValues = 4096 / sizeof(TValue) > 0 ? 4096 / sizeof(TValue) : 1;
+	alignas(TValue) unsigned char buffer[chunkValues * sizeof(TValue)];
+	std::size_t buffered = 0;
+	for (auto n = head; n != nullptr; n = n->next)
+	{
+		std::memcpy(buffer + buffered * sizeof(TValue), &n->data, sizeof(TValue));
+		if (++buffered == chunkValues)
+		{
+			out.write(reinterpret_cast<const char*>(buffer), buffered * sizeof(TValue));
+			buffered = 0;
+		}
+	}
+	out.write(reinterpret_cast<const char*>(buffer), buffered * sizeof(TValue));
+
+	if (!out) throw std::runtime_error("failed to write list");
+}
+
+template<typename TValue, std::size_t InlineN>
+inline LinkedList<TValue, InlineN> LinkedList<TValue, InlineN>::deserialize(std::istream& in) requires std::is_trivially_copyable_v<TValue>
+{
+	std::uint64_t size = 0;
+	if (!in.read(reinterpret_cast<char*>(&size), sizeof(size))) throw std::runtime_error("failed to read list");
+
+	constexpr std::size_t chunkValues = 4096 / sizeof(TValue) > 0 ? 4096 / sizeof(TValue) : 1;
+	alignas(TValue) unsigned char buffer[chunkValues * sizeof(TValue)];
+
+	LinkedList<TValue, InlineN> list;
+	while (size > 0)
+	{
+		auto chunk = static_cast<std::size_t>(size < chunkValues ? size : chunkValues);
+		if (!in.read(reinterpret_cast<char*>(buffer), chunk * sizeof(TValue))) throw std::runtime_error("failed to read list");
+
+		auto first = std::launder(reinterpret_cast<const TValue*>(buffer));
+		list.insert(list.end(), first, first + chunk);
+		size -= chunk;
+	}
+	return list;
+}
+
+template<typename TValue, std::size_t InlineN>
+inline constexpr LinkedList<TValue, InlineN>::Node* LinkedList<TValue, InlineN>::createNode(const TValue& val)
+{
+	if (std::is_constant_evaluated())
+	{
+		// placement new into the pool or the inline slots is not allowed in constant expressions, plain new is
+		return new Node(val);
+	}
+
+	if constexpr (InlineN > 0)
+	{
+		typename InlineNodes::Slot* slot = nullptr;
+		if (inlineNodes.freeList != nullptr)
+		{
+			slot = inlineNodes.freeList;
+			inlineNodes.freeList = slot->nextFree;
+		}
+		else if (inlineNodes.used < InlineN)
+		{
+			slot = &inlineNodes.slots[inlineNodes.used++];
+		}
+
+		if (slot != nullptr)
+		{
+			return ::new (slot->storage) Node(val);
+		}
+	}
+
+	if (arena != nullptr)
+	{
+		auto memory = arena->allocate(sizeof(Node), alignof(Node));
+		try
+		{
+			return ::new (memory) Node(val);
+		}
+		catch (...)
+		{
+			arena->deallocate(memory, sizeof(Node));
+			throw;
+		}
+	}
+
+	if constexpr (pooled)
+	{
+		return pool.create(val);
+	}
+	else
+	{
+		// nodes freed on another thread come back through that thread's cache, not the heap's cross-thread path
+		auto memory = NodeCache<Node>::allocate();
+		try
+		{
+			return ::new (memory) Node(val);
+		}
+		catch (...)
+		{
+			NodeCache<Node>::deallocate(memory);
+			throw;
+		}
+	}
+}
+
+template<typename TValue, std::size_t InlineN>
+inline constexpr void LinkedList<TValue, InlineN>::destroyNode(Node* node) noexcept
+{
+	if (std::is_constant_evaluated())
+	{
+		delete node;
+		return;
+	}
+
+	if constexpr (InlineN > 0)
+	{
+		if (isInline(node))
+		{
+			node->~Node();
+			auto slot = reinterpret_cast<typename InlineNodes::Slot*>(node);
+			slot->nextFree = inlineNodes.freeList;
+			inlineNodes.freeList = slot;
+			return;
+		}
+	}
+
+	if (arena != nullptr)
+	{
+		node->~Node();
+		arena->deallocate(node, sizeof(Node));
+		return;
+	}
+
+	if constexpr (pooled)
+	{
+		pool.destroy(node);
+	}
+	else
+	{
+		node->~Node();
+		NodeCache<Node>::deallocate(node);
+	}
+}
+
+template<typename TValue, std::size_t InlineN>
+inline constexpr void LinkedList<TValue, InlineN>::destroyChain(Node* first) noexcept
+{
+	// iterative, freeing a long chain recursively would overflow the stack
+	while (first != nullptr)
+	{
+		auto next = first->next;
+		destroyNode(first);
+		first = next;
+	}
+}
+
+template<typename TValue, std::size_t InlineN>
+inline constexpr bool LinkedList<TValue, InlineN>::isInline(const Node* node) const noexcept
+{
+	if constexpr (InlineN > 0)
+	{
+		auto first = reinterpret_cast<const Node*>(inlineNodes.slots);
+		auto last = reinterpret_cast<const Node*>(inlineNodes.slots + InlineN);
+		return !std::less<const Node*>()(node, first) && std::less<const Node*>()(node, last);
+	}
+	else
+	{
+		return false;
+	}
+}
+
+template<typename TValue, std::size_t InlineN>
+inline constexpr void LinkedList<TValue, InlineN>::takeNodes(LinkedList& other)
+{
+	if constexpr (InlineN > 0)
+	{
+		// inline nodes belong to the other list object, so the values have to be copied
+		insert(end(), other.begin(), other.end());
+		other.clear();
+	}
+	else
+	{
+		head = std::exchange(other.head, nullptr);
+		tail = std::exchange(other.tail, nullptr);
+		count = std::exchange(other.count, 0);
+		arena = other.arena;
+		pool = std::move(other.pool);
+	}
+}
+
+template<typename TValue, std::size_t InlineN>
+inline constexpr LinkedList<TValue, InlineN>::Node* LinkedList<TValue, InlineN>::detachAllocatedNodes() noexcept
+{
+	if constexpr (InlineN > 0)
+	{
+		Node* first = nullptr;
+		Node* last = nullptr;
+		auto n = head;
+		while (n != nullptr)
+		{
+			auto next = n->next;
+			if (isInline(n))
+			{
+				destroyNode(n);
+			}
+			else
+			{
+				(last != nullptr ? last->next : first) = n;
+				last = n;
+			}
+			n = next;
+		}
+		if (last != nullptr)
+		{
+			last->next = nullptr;
+		}
+		return first;
+	}
+	else
+	{
+		return head;
+	}
+}
+
+template<typename TValue, std::size_t InlineN>
+inline constexpr void LinkedList<TValue, InlineN>::linkChain(Node* node, Node* first, Node* last) noexcept
+{
+	last->next = node;
+	first->prev = node != nullptr ? node->prev : tail;
+
+	if (last->next != nullptr)
+	{
+		last->next->prev = last;
+	}
+	else
+	{
+		// new tail
+		tail = last;
+	}
+
+	if (first->prev != nullptr)
+	{
+		first->prev->next = first;
+	}
+	else
+	{
+		// new head
+		head = first;
+	}
+}
+
+template<typename TValue, std::size_t InlineN>
+template<typename TCompare>
+inline constexpr LinkedList<TValue, InlineN>::Node* LinkedList<TValue, InlineN>::mergeSort(Node* first, size_type n, TCompare& compare)
+{
+	if (n < 2)
+	{
+		return first;
+	}
+
+	// split after the first half, recursion depth is log2(n)
+	auto half = n / 2;
+	auto last = first;
+	for (size_type i = 1; i < half; i++)
+	{
+		last = last->next;
+	}
+	auto second = last->next;
+	last->next = nullptr;
+
+	first = mergeSort(first, half, compare);
+	second = mergeSort(second, n - half, compare);
+
+	// merge, taking from the first half on ties so the sort is stable
+	Node* merged = nullptr;
+	Node** link = &merged;
+	while (first != nullptr && second != nullptr)
+	{
+		auto& next = compare(second->data, first->data) ? second : first;
+		*link = next;
+		link = &next->next;
+		next = next->next;
+	}
+	*link = first != nullptr ? first : second;
+	return merged;
+}
+
+template<typename TValue, std::size_t InlineN>
+inline std::size_t LinkedList<TValue, InlineN>::releaseChain(void*& chain, std::size_t budget)
+{
+	// iterative, freeing a long chain recursively would overflow the stack
+	auto n = static_cast<Node*>(chain);
+	std::size_t freed = 0;
+	while (n != nullptr && freed < budget)
+	{
+		auto next = n->next;
+		n->~Node();
+		NodeCache<Node>::deallocate(n);
+		n = next;
+		freed++;
+	}
+	chain = n;
+	return freed;
+}
+
+template<typename TValue, std::size_t InlineN>
+inline constexpr LinkedList<TValue, InlineN>::iterator LinkedList<TValue, InlineN>::find(const TValue& val)
+{
+	auto n = head;
+	while (n != nullptr && !(n->data == val))
+	{
+		n = n->next;
+	}
+	return iterator(n);
+}
+
+template<typename TValue, std::size_t InlineN>
+inline constexpr bool LinkedList<TValue, InlineN>::contains(const TValue& val) const
+{
+	for (auto n = head; n != nullptr; n = n->next)
+	{
+		if (n->data == val)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+template<typename TValue, std::size_t InlineN>
+inline constexpr LinkedList<TValue, InlineN>::iterator LinkedList<TValue, InlineN>::erase(iterator pos)
+{
+	auto next = pos.current->next;
+	removeNode(pos.current);
+	return iterator(next);
+}
+
+template<typename TValue, std::size_t InlineN>
+inline constexpr LinkedList<TValue, InlineN>::iterator LinkedList<TValue, InlineN>::begin() noexcept
 {
 	return iterator(head);
 }
 
-template<typename TValue>
-inline LinkedList<TValue>::iterator LinkedList<TValue>::end() noexcept
+template<typename TValue, std::size_t InlineN>
+inline constexpr LinkedList<TValue, InlineN>::iterator LinkedList<TValue, InlineN>::end() noexcept
 {
 	return iterator(nullptr);
 }
 
-template<typename TValue>
-inline LinkedList<TValue>::iterator LinkedList<TValue>::rbegin() noexcept
+template<typename TValue, std::size_t InlineN>
+inline constexpr LinkedList<TValue, InlineN>::iterator LinkedList<TValue, InlineN>::rbegin() noexcept
 {
 	return iterator(tail);
 }
 
-template<typename TValue>
-inline LinkedList<TValue>::iterator LinkedList<TValue>::rend() noexcept
+template<typename TValue, std::size_t InlineN>
+inline constexpr LinkedList<TValue, InlineN>::iterator LinkedList<TValue, InlineN>::rend() noexcept
 {
 	return iterator(nullptr);
 }
 
-template<typename TValue>
-inline LinkedList<TValue>::const_iterator LinkedList<TValue>::begin() const noexcept
+template<typename TValue, std::size_t InlineN>
+inline constexpr LinkedList<TValue, InlineN>::const_iterator LinkedList<TValue, InlineN>::begin() const noexcept
 {
 	return const_iterator(head);
 }
 
-template<typename TValue>
-inline LinkedList<TValue>::const_iterator LinkedList<TValue>::end() const noexcept
+template<typename TValue, std::size_t InlineN>
+inline constexpr LinkedList<TValue, InlineN>::const_iterator LinkedList<TValue, InlineN>::end() const noexcept
 {
 	return const_iterator(nullptr);
 }
 
-template<typename TValue>
-inline LinkedList<TValue>::const_iterator LinkedList<TValue>::cbegin() const noexcept
+template<typename TValue, std::size_t InlineN>
+inline constexpr LinkedList<TValue, InlineN>::const_iterator LinkedList<TValue, InlineN>::cbegin() const noexcept
 {
 	return const_iterator(head);
 }
 
-template<typename TValue>
-inline LinkedList<TValue>::const_iterator LinkedList<TValue>::cend() const noexcept
+template<typename TValue, std::size_t InlineN>
+inline constexpr LinkedList<TValue, InlineN>::const_iterator LinkedList<TValue, InlineN>::cend() const noexcept
 {
 	return const_iterator(nullptr);
 }
 
-template<typename TValue>
-inline std::string LinkedList<TValue>::toString() const
+template<typename TValue, std::size_t InlineN>
+inline std::string LinkedList<TValue, InlineN>::toString() const
 {
 	std::stringstream ss;
 
@@ -494,7 +1224,7 @@ inline std::string LinkedList<TValue>::toString() const
 }
 
 template<typename TValue>
-inline std::string LinkedList<TValue>::Node::toString() const
+inline std::string LinkedListNode<TValue>::toString() const
 {
 	std::stringstream ss;
 	ss << '[' << data << ']';
@@ -0,0 +1,540 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+
+	@class   LinkedListForest
+	@brief   Many singly-linked lists sharing one node pool, e.g. the adjacency lists of a graph
+
+	@details ~ A list is only a 12 byte header (first node, last node, count, all 32-bit) identified by a ListId,
+			   and every list's nodes live in one shared array, linked by 32-bit index instead of pointer.
+			   A node of an int list is 8 bytes, with no heap header and no per-list allocation.
+			   append() takes a whole range of values into consecutive nodes, clear(list) gives all of a list's
+			   nodes back to the shared free list in O(1) by splicing, and compact() rewrites the node array so that
+			   every list's nodes are consecutive and in order, turning traversals into sequential scans.
+			   Node indices change on compact(), iterators are invalidated by any insertion.
+	@tparam  TValue - type of the lists' values
+
+**/
+template<typename TValue>
+class LinkedListForest
+{
+public:
+	using value_type = TValue;
+	using reference = value_type&;
+	using const_reference = const value_type&;
+	using size_type = std::size_t;
+	using ListId = std::uint32_t;
+
+	class iterator;
+	class ListView;
+
+	/**
+		@brief Construct a forest holding the given number of empty lists
+		@param lists - number of lists to create, with ids 0 to lists - 1
+	**/
+	explicit LinkedListForest(size_type lists = 0);
+
+	/**
+		@brief  Create a new empty list
+
+		Performs in O(1) amortized constant time
+		@retval ListId id of the new list
+	**/
+	ListId addList();
+
+	/**
+		@brief  Create several new empty lists with consecutive ids
+		@param  lists - number of lists to create
+		@retval ListId id of the first new list
+	**/
+	ListId addLists(size_type lists);
+
+	/**
+		@brief  Number of lists in the forest
+	**/
+	size_type listCount() const noexcept;
+
+	/**
+		@brief  Number of values in all lists
+	**/
+	size_type valueCount() const noexcept;
+
+	/**
+		@brief  Returns number of values in a list
+
+		Performs in O(1) constant time
+	**/
+	size_type size(ListId list) const;
+
+	/**
+		@brief  Determines if a list is empty
+
+		Performs in O(1) constant time
+	**/
+	bool empty(ListId list) const;
+
+	/**
+		@brief Add a value to the front of a list
+
+		Performs in O(1) amortized constant time
+	**/
+	void push_front(ListId list, const TValue& val);
+
+	/**
+		@brief Add a value to the end of a list
+
+		Performs in O(1) amortized constant time
+	**/
+	void push_back(ListId list, const TValue& val);
+
+	/**
+		@brief Add a range of values to the end of a list
+
+		The values get consecutive nodes unless freed nodes are waiting to be reused.
+		Performs in O(k) linear time, where k = the number of values appended
+	**/
+	template<typename TInputIt>
+	void append(ListId list, TInputIt first, TInputIt last);
+
+	/**
+		@brief  Return the value at the beginning of a list
+		@exception std::runtime_error if the list is empty
+	**/
+	reference front(ListId list);
+	const_reference front(ListId list) const;
+
+	/**
+		@brief  Removes the value at the beginning of a list and returns it
+
+		Performs in O(1) constant time
+		@exception std::runtime_error if the list is empty
+	**/
+	value_type pop_front(ListId list);
+
+	/**
+		@brief Removes all values of a list, the list itself stays
+
+		Splices the list's nodes onto the free list, performs in O(1) constant time
+	**/
+	void clear(ListId list);
+
+	/**
+		@brief Removes all lists and values
+	**/
+	void clear() noexcept;
+
+	/**
+		@brief  Range over the values of a list, for use with range-based for
+	**/
+	ListView values(ListId list);
+
+	/**
+		@brief Rewrite the node array so every list's nodes are consecutive and in list order, dropping freed nodes
+
+		Performs in O(n + m) linear time, where n = number of values and m = number of lists
+	**/
+	void compact();
+
+	/**
+		@brief  Reserve room for a total number of values
+	**/
+	void reserve(size_type values);
+
+	/**
+		@brief  Bytes of heap memory used by list headers and nodes, including unused capacity
+	**/
+	size_type memoryUsage() const noexcept;
+
+	/**
+		@brief Get string representation of a list's values suitable for display
+	**/
+	std::string toString(ListId list) const;
+
+private:
+	using Index = std::uint32_t;
+	static constexpr Index None = std::numeric_limits<Index>::max();
+
+	struct Node
+	{
+		Index next;
+		TValue value;
+	};
+
+	struct ListHeader
+	{
+		Index head;
+		Index tail;
+		std::uint32_t count;
+	};
+
+	std::vector<ListHeader> lists;
+	std::vector<Node> nodes;
+
+	// freed nodes, linked through Node::next
+	Index freeList;
+	size_type freeCount;
+
+	// Take a node for val, reusing a freed node if there is one
+	Index allocate(const TValue& val);
+
+	// Throws if list is not a valid id
+	void check(ListId list) const;
+};
+
+/**
+	@class  LinkedListForest::iterator
+	@brief  Forward iterator over the values of one list of a LinkedListForest
+**/
+template<typename TValue>
+class LinkedListForest<TValue>::iterator
+{
+public:
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = TValue;
+	using difference_type = std::ptrdiff_t;
+	using pointer = value_type*;
+	using reference = value_type&;
+
+	constexpr iterator() noexcept
+		: nodes(nullptr)
+		, current(None)
+	{}
+
+	reference operator*() const noexcept
+	{
+		return nodes[current].value;
+	}
+
+	pointer operator->() const noexcept
+	{
+		return &nodes[current].value;
+	}
+
+	iterator& operator++() noexcept
+	{
+		current = nodes[current].next;
+		return *this;
+	}
+
+	iterator operator++(int) noexcept
+	{
+		auto it = *this;
+		++*this;
+		return it;
+	}
+
+	bool operator==(const iterator& other) const noexcept
+	{
+		return current == other.current;
+	}
+
+	bool operator!=(const iterator& other) const noexcept
+	{
+		return !(*this == other);
+	}
+
+private:
+	Node* nodes;
+	Index current;
+
+	constexpr iterator(Node* nodes, Index current) noexcept
+		: nodes(nodes)
+		, current(current)
+	{}
+
+	friend class LinkedListForest<TValue>;
+};
+
+/**
+	@class  LinkedListForest::ListView
+	@brief  begin()/end() pair over one list of a LinkedListForest
+**/
+template<typename TValue>
+class LinkedListForest<TValue>::ListView
+{
+public:
+	iterator begin() const noexcept
+	{
+		return first;
+	}
+
+	iterator end() const noexcept
+	{
+		return iterator(nullptr, None);
+	}
+
+private:
+	iterator first;
+
+	explicit ListView(iterator first) noexcept
+		: first(first)
+	{}
+
+	friend class LinkedListForest<TValue>;
+};
+
+template<typename TValue>
+inline LinkedListForest<TValue>::LinkedListForest(size_type lists)
+	: lists(lists, ListHeader{ None, None, 0 })
+	, nodes()
+	, freeList(None)
+	, freeCount(0)
+{}
+
+template<typename TValue>
+inline typename LinkedListForest<TValue>::ListId LinkedListForest<TValue>::addList()
+{
+	return addLists(1);
+}
+
+template<typename TValue>
+inline typename LinkedListForest<TValue>::ListId LinkedListForest<TValue>::addLists(size_type count)
+{
+	if (lists.size() + count > None) throw std::runtime_error("too many lists");
+
+	auto first = static_cast<ListId>(lists.size());
+	lists.resize(lists.size() + count, ListHeader{ None, None, 0 });
+	return first;
+}
+
+template<typename TValue>
+inline std::size_t LinkedListForest<TValue>::listCount() const noexcept
+{
+	return lists.size();
+}
+
+template<typename TValue>
+inline std::size_t LinkedListForest<TValue>::valueCount() const noexcept
+{
+	return nodes.size() - freeCount;
+}
+
+template<typename TValue>
+inline std::size_t LinkedListForest<TValue>::size(ListId list) const
+{
+	check(list);
+	return lists[list].count;
+}
+
+template<typename TValue>
+inline bool LinkedListForest<TValue>::empty(ListId list) const
+{
+	check(list);
+	return lists[list].count == 0;
+}
+
+template<typename TValue>
+inline void LinkedListForest<TValue>::push_front(ListId list, const TValue& val)
+{
+	check(list);
+	auto node = allocate(val);
+	auto& header = lists[list];
+	nodes[node].next = header.head;
+	header.head = node;
+	if (header.tail == None)
+	{
+		header.tail = node;
+	}
+	header.count++;
+}
+
+template<typename TValue>
+inline void LinkedListForest<TValue>::push_back(ListId list, const TValue& val)
+{
+	check(list);
+	auto node = allocate(val);
+	auto& header = lists[list];
+	if (header.tail != None)
+	{
+		nodes[header.tail].next = node;
+	}
+	else
+	{
+		header.head = node;
+	}
+	header.tail = node;
+	header.count++;
+}
+
+template<typename TValue>
+template<typename TInputIt>
+inline void LinkedListForest<TValue>::append(ListId list, TInputIt first, TInputIt last)
+{
+	check(list);
+	if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<TInputIt>::iterator_category>)
+	{
+		// grow once, so the new nodes are consecutive
+		auto count = static_cast<size_type>(std::distance(first, last));
+		auto needed = nodes.size() + (count > freeCount ? count - freeCount : 0);
+		if (needed > nodes.capacity())
+		{
+			nodes.reserve(needed > 2 * nodes.capacity() ? needed : 2 * nodes.capacity());
+		}
+	}
+
+	for (; first != last; ++first)
+	{
+		push_back(list, *first);
+	}
+}
+
+template<typename TValue>
+inline TValue& LinkedListForest<TValue>::front(ListId list)
+{
+	check(list);
+	if (lists[list].head == None) throw std::runtime_error("list is empty");
+	return nodes[lists[list].head].value;
+}
+
+template<typename TValue>
+inline const TValue& LinkedListForest<TValue>::front(ListId list) const
+{
+	check(list);
+	if (lists[list].head == None) throw std::runtime_error("list is empty");
+	return nodes[lists[list].head].value;
+}
+
+template<typename TValue>
+inline TValue LinkedListForest<TValue>::pop_front(ListId list)
+{
+	check(list);
+	auto& header = lists[list];
+	if (header.head == None) throw std::runtime_error("cannot remove from empty list");
+
+	auto node = header.head;
+	auto val = std::move(nodes[node].value);
+	header.head = nodes[node].next;
+	if (header.head == None)
+	{
+		header.tail = None;
+	}
+	header.count--;
+
+	nodes[node].next = freeList;
+	freeList = node;
+	freeCount++;
+	return val;
+}
+
+template<typename TValue>
+inline void LinkedListForest<TValue>::clear(ListId list)
+{
+	check(list);
+	auto& header = lists[list];
+	if (header.head == None)
+	{
+		return;
+	}
+
+	// the whole chain goes onto the free list at once
+	nodes[header.tail].next = freeList;
+	freeList = header.head;
+	freeCount += header.count;
+	header = ListHeader{ None, None, 0 };
+}
+
+template<typename TValue>
+inline void LinkedListForest<TValue>::clear() noexcept
+{
+	lists.clear();
+	nodes.clear();
+	freeList = None;
+	freeCount = 0;
+}
+
+template<typename TValue>
+inline typename LinkedListForest<TValue>::ListView LinkedListForest<TValue>::values(ListId list)
+{
+	check(list);
+	return ListView(iterator(nodes.data(), lists[list].head));
+}
+
+template<typename TValue>
+inline void LinkedListForest<TValue>::compact()
+{
+	std::vector<Node> ordered;
+	ordered.reserve(valueCount());
+	for (auto& header : lists)
+	{
+		if (header.head == None)
+		{
+			continue;
+		}
+
+		auto first = static_cast<Index>(ordered.size());
+		for (auto n = header.head; n != None; n = nodes[n].next)
+		{
+			ordered.push_back(Node{ static_cast<Index>(ordered.size() + 1), std::move(nodes[n].value) });
+		}
+		ordered.back().next = None;
+		header.head = first;
+		header.tail = static_cast<Index>(ordered.size() - 1);
+	}
+
+	nodes = std::move(ordered);
+	freeList = None;
+	freeCount = 0;
+}
+
+template<typename TValue>
+inline void LinkedListForest<TValue>::reserve(size_type values)
+{
+	nodes.reserve(values);
+}
+
+template<typename TValue>
+inline std::size_t LinkedListForest<TValue>::memoryUsage() const noexcept
+{
+	return lists.capacity() * sizeof(ListHeader) + nodes.capacity() * sizeof(Node);
+}
+
+template<typename TValue>
+inline std::string LinkedListForest<TValue>::toString(ListId list) const
+{
+	check(list);
+	std::stringstream ss;
+	for (auto n = lists[list].head; n != None; n = nodes[n].next)
+	{
+		ss << '[' << nodes[n].value << ']';
+		if (nodes[n].next != None)
+		{
+			ss << "->";
+		}
+	}
+	return ss.str();
+}
+
+template<typename TValue>
+inline typename LinkedListForest<TValue>::Index LinkedListForest<TValue>::allocate(const TValue& val)
+{
+	if (freeList != None)
+	{
+		auto node = freeList;
+		freeList = nodes[node].next;
+		freeCount--;
+		nodes[node] = Node{ None, val };
+		return node;
+	}
+
+	if (nodes.size() >= None) throw std::runtime_error("forest is full");
+
+	nodes.push_back(Node{ None, val });
+	return static_cast<Index>(nodes.size() - 1);
+}
+
+template<typename TValue>
+inline void LinkedListForest<TValue>::check(ListId list) const
+{
+	if (list >= lists.size()) throw std::runtime_error("invalid list id");
+}
@@ -1,8 +1,10 @@
 #pragma once
 
+#include <cstddef>
 #include <iterator>
 
-template<typename TValue> class LinkedList;
+template<typename TValue, std::size_t InlineN> class LinkedList;
+template<typename TValue> struct LinkedListNode;
 
 /**
 
@@ -36,98 +38,98 @@ public:
 		@brief  Allows de-referencing of the iterator to return the current value
 		@retval  - TValue reference to the value the iterator is currently pointing to
 	**/
-	reference operator*();
+	constexpr reference operator*();
 
 	/**
 		@brief  Advances the iterator forward by one position
 		@retval  - iterator instance advanced forward by one poistion
 	**/
-	const LinkedListIterator<TValue>& operator++();
+	constexpr const LinkedListIterator<TValue>& operator++();
 
 	/**
 		@brief  Advances the iterator forward by one position
 		@retval  - iterator instance advanced forward by one poistion
 	**/
-	const LinkedListIterator<TValue> operator++(int);
+	constexpr const LinkedListIterator<TValue> operator++(int);
 
 	/**
 		@brief  Advances the iterator backward by one position
 		@retval  - iterator instance advanced backward by one position
 	**/
-	const LinkedListIterator<TValue>& operator--();
+	constexpr const LinkedListIterator<TValue>& operator--();
 
 	/**
 		@brief  Advances the iterator backward by one position
 		@retval  - iterator instance advanced backward by one position
 	**/
-	const LinkedListIterator<TValue> operator--(int);
+	constexpr const LinkedListIterator<TValue> operator--(int);
 
 	/**
 		@brief  Tests equality against the provided iterator
 		@param  other - iterator to test equality against
 		@retval       - false if both iterators point at the same position in the list, true otherwise
 	**/
-	bool operator==(const LinkedListIterator<TValue>& other);
+	constexpr bool operator==(const LinkedListIterator<TValue>& other);
 
 	/**
 		@brief  Tests inequality against the provided iterator
 		@param  other - iterator to test inequality against
 		@retval       - true if both iterators point at the same position in the list, false otherwise
 	**/
-	bool operator!=(const LinkedListIterator<TValue>& other);
+	constexpr bool operator!=(const LinkedListIterator<TValue>& other);
 
 protected:
-	LinkedList<TValue>::Node* current;
+	LinkedListNode<TValue>* current;
 
 	// Create a LinkedListIterator pointing to the provided position
-	explicit constexpr LinkedListIterator(LinkedList<TValue>::Node* current) noexcept
+	explicit constexpr LinkedListIterator(LinkedListNode<TValue>* current) noexcept
 		: current(current)
 	{}
 
-	friend class LinkedList<value_type>;
+	template<typename, std::size_t> friend class LinkedList;
 };
 
 template<typename TValue>
-inline LinkedListIterator<TValue>::reference LinkedListIterator<TValue>::operator*()
+inline constexpr LinkedListIterator<TValue>::reference LinkedListIterator<TValue>::operator*()
 {
 	return current->data;
 }
 
 template<typename TValue>
-inline const LinkedListIterator<TValue>& LinkedListIterator<TValue>::operator++()
+inline constexpr const LinkedListIterator<TValue>& LinkedListIterator<TValue>::operator++()
 {
 	current = current->next;
 	return *this;
 }
 
 template<typename TValue>
-inline const LinkedListIterator<TValue> LinkedListIterator<TValue>::operator++(int)
+inline constexpr const LinkedListIterator<TValue> LinkedListIterator<TValue>::operator++(int)
 {
 	return this->operator++();
 }
 
 template<typename TValue>
-inline const LinkedListIterator<TValue>& LinkedListIterator<TValue>::operator--()
+inline constexpr const LinkedListIterator<TValue>& LinkedListIterator<TValue>::operator--()
 {
 	current = current->prev;
 	return *this;
 }
 
 template<typename TValue>
-inline const LinkedListIterator<TValue> LinkedListIterator<TValue>::operator--(int)
+inline constexpr const LinkedListIterator<TValue> LinkedListIterator<TValue>::operator--(int)
 {
 	return this->operator--();
 }
 
 template<typename TValue>
-inline bool LinkedListIterator<TValue>::operator==(const LinkedListIterator<TValue>& other)
+inline constexpr bool LinkedListIterator<TValue>::operator==(const LinkedListIterator<TValue>& other)
 {
 	//return other.current != nullptr && this->current == other.current;
 	return current == other.current;
 }
 
 template<typename TValue>
-inline bool LinkedListIterator<TValue>::operator!=(const LinkedListIterator<TValue>& other)
+inline constexpr bool LinkedListIterator<TValue>::operator!=(const LinkedListIterator<TValue>& other)
 {
 	//return ! (*this).operator==(other);
 	return !(*this == other);
@@ -138,21 +140,29 @@ template<typename TValue>
 class ConstLinkedListIterator : public LinkedListIterator<TValue>
 {
 public:
+	using pointer = const typename LinkedListIterator<TValue>::value_type*;
+	using reference = const typename LinkedListIterator<TValue>::value_type&;
+
 	constexpr ConstLinkedListIterator() noexcept
 		: ConstLinkedListIterator(nullptr)
 	{}	
 	
-	const LinkedListIterator<TValue>::reference operator*() const;
+	/**
+		@brief  Allows de-referencing of the iterator to return the current value, read-only
+		@retval  - const TValue reference to the value the iterator is currently pointing to
+	**/
+	constexpr reference operator*() const;
 
 private:
-	constexpr explicit ConstLinkedListIterator(LinkedList<TValue>::Node* current) noexcept
+	constexpr explicit ConstLinkedListIterator(LinkedListNode<TValue>* current) noexcept
 		: LinkedListIterator<TValue>(current)
 	{}
 
+	template<typename, std::size_t> friend class LinkedList;
 };
 
 template<typename TValue>
-inline const LinkedListIterator<TValue>::reference ConstLinkedListIterator<TValue>::operator*() const
+inline constexpr ConstLinkedListIterator<TValue>::reference ConstLinkedListIterator<TValue>::operator*() const
 {
 	return this->current->data;
 }
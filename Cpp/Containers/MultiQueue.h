@@ -0,0 +1,249 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "ThreadRandom.h"
+
+/**
+
+	@class   MultiQueue
+	@brief   Relaxed concurrent priority queue built from many internally locked sub-queues
+
+	@details ~ A single priority queue under one lock serialises every scheduler thread. MultiQueue spreads the values over
+			   many binary heaps, each with it's own lock: push() adds to a random heap, pop() locks two random heaps and
+			   takes the better of their tops. Threads rarely meet on the same lock, so throughput grows with the number of
+			   threads, and a popped value is not always the best one but, on average, close to it (it's expected rank is
+			   O(number of heaps)). Locks are only tried; a busy heap is skipped for another random one, so no thread waits
+			   behind another. pop() on an apparently empty queue checks every heap before reporting it empty.
+			   Follows std::priority_queue ordering: with std::less the largest value is popped first.
+	@tparam  TValue   - type of queue's values
+	@tparam  TCompare - strict weak ordering, the value that compares greatest has the highest priority
+
+**/
+template<typename TValue, typename TCompare = std::less<TValue>>
+class MultiQueue
+{
+public:
+	using value_type = TValue;
+	using size_type = std::size_t;
+
+	/**
+		@brief Construct an empty queue
+		@param queues  - number of sub-queues, at least 2; about twice the number of threads using the queue works well
+		@param compare - priority ordering
+	**/
+	explicit MultiQueue(std::size_t queues = 2 * std::max(1u, std::thread::hardware_concurrency()), TCompare compare = TCompare());
+
+	MultiQueue(const MultiQueue&) = delete;
+	MultiQueue& operator=(const MultiQueue&) = delete;
+
+	/**
+		@brief  Number of values in the queue, exact only while no other thread pushes or pops
+
+		Performs in O(1) constant time
+	**/
+	size_type size() const noexcept;
+
+	/**
+		@brief  Determines if the queue is empty, exact only while no other thread pushes or pops
+
+		Performs in O(1) constant time
+	**/
+	bool empty() const noexcept;
+
+	/**
+		@brief  Number of sub-queues
+	**/
+	size_type queues() const noexcept;
+
+	/**
+		@brief Add a value, safe to call from any thread
+
+		Performs in O(log(n/q)) time, where n = the number of values and q = the number of sub-queues
+		@param val - value to add
+	**/
+	void push(const TValue& val);
+	void push(TValue&& val);
+
+	/**
+		@brief  Remove a high priority value and return it, safe to call from any thread
+
+		Performs in O(log(n/q)) time; O(q) when the queue is empty or nearly so
+		@exception std::runtime_error if queue is empty
+		@retval TValue the better of the top values of two random sub-queues
+	**/
+	value_type pop();
+
+	/**
+		@brief  Remove a high priority value, if there is one
+
+		Performs in O(log(n/q)) time; O(q) when the queue is empty or nearly so
+		@param  out - receives the removed value
+		@retval bool true if a value was removed, false if every sub-queue was empty
+	**/
+	bool try_pop(TValue& out);
+
+private:
+	struct alignas(64) SubQueue
+	{
+		std::mutex mutex;
+		// binary heap ordered by compare
+		std::vector<TValue> heap;
+	};
+
+	const std::size_t queueCount;
+	std::unique_ptr<SubQueue[]> subQueues;
+	TCompare compare;
+	std::atomic<std::size_t> count;
+
+	template<typename TArg>
+	void add(TArg&& val);
+
+	// Remove the top of a locked, non-empty sub-queue
+	TValue takeTop(SubQueue& queue);
+
+	// Pop from the better of two random sub-queues, falling back to a scan of all; nothing if all were empty
+	std::optional<TValue> take();
+};
+
+template<typename TValue, typename TCompare>
+inline MultiQueue<TValue, TCompare>::MultiQueue(std::size_t queues, TCompare compare)
+	: queueCount(queues < 2 ? 2 : queues)
+	, subQueues(new SubQueue[queueCount])
+	, compare(std::move(compare))
+	, count(0)
+{}
+
+template<typename TValue, typename TCompare>
+inline std::size_t MultiQueue<TValue, TCompare>::size() const noexcept
+{
+	return count.load(std::memory_order_relaxed);
+}
+
+template<typename TValue, typename TCompare>
+inline bool MultiQueue<TValue, TCompare>::empty() const noexcept
+{
+	return count.load(std::memory_order_relaxed) == 0;
+}
+
+template<typename TValue, typename TCompare>
+inline std::size_t MultiQueue<TValue, TCompare>::queues() const noexcept
+{
+	return queueCount;
+}
+
+template<typename TValue, typename TCompare>
+inline void MultiQueue<TValue, TCompare>::push(const TValue& val)
+{
+	add(val);
+}
+
+template<typename TValue, typename TCompare>
+inline void MultiQueue<TValue, TCompare>::push(TValue&& val)
+{
+	add(std::move(val));
+}
+
+template<typename TValue, typename TCompare>
+inline TValue MultiQueue<TValue, TCompare>::pop()
+{
+	auto val = take();
+	if (!val) throw std::runtime_error("cannot remove from empty list");
+	return std::move(*val);
+}
+
+template<typename TValue, typename TCompare>
+inline bool MultiQueue<TValue, TCompare>::try_pop(TValue& out)
+{
+	auto val = take();
+	if (!val)
+	{
+		return false;
+	}
+	out = std::move(*val);
+	return true;
+}
+
+template<typename TValue, typename TCompare>
+template<typename TArg>
+inline void MultiQueue<TValue, TCompare>::add(TArg&& val)
+{
+	while (true)
+	{
+		auto& queue = subQueues[threadRandom() % queueCount];
+		std::unique_lock<std::mutex> lock(queue.mutex, std::try_to_lock);
+		if (lock.owns_lock())
+		{
+			queue.heap.push_back(std::forward<TArg>(val));
+			std::push_heap(queue.heap.begin(), queue.heap.end(), compare);
+			count.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+	}
+}
+
+template<typename TValue, typename TCompare>
+inline TValue MultiQueue<TValue, TCompare>::takeTop(SubQueue& queue)
+{
+	std::pop_heap(queue.heap.begin(), queue.heap.end(), compare);
+	TValue val = std::move(queue.heap.back());
+	queue.heap.pop_back();
+	count.fetch_sub(1, std::memory_order_relaxed);
+	return val;
+}
+
+template<typename TValue, typename TCompare>
+inline std::optional<TValue> MultiQueue<TValue, TCompare>::take()
+{
+	// two random sub-queues while the queue looks busy enough for them to hold values
+	for (std::size_t attempt = 0; attempt < queueCount && count.load(std::memory_order_relaxed) > 0; attempt++)
+	{
+		auto i = threadRandom() % queueCount;
+		auto j = threadRandom() % queueCount;
+		if (i == j)
+		{
+			j = (j + 1) % queueCount;
+		}
+
+		std::unique_lock<std::mutex> first(subQueues[i].mutex, std::try_to_lock);
+		if (!first.owns_lock())
+		{
+			continue;
+		}
+		std::unique_lock<std::mutex> second(subQueues[j].mutex, std::try_to_lock);
+		if (!second.owns_lock())
+		{
+			continue;
+		}
+
+		auto& a = subQueues[i].heap;
+		auto& b = subQueues[j].heap;
+		if (a.empty() && b.empty())
+		{
+			continue;
+		}
+		auto& better = b.empty() || (!a.empty() && !compare(a.front(), b.front())) ? subQueues[i] : subQueues[j];
+		return takeTop(better);
+	}
+
+	// nearly empty: sampling keeps missing, look at every sub-queue
+	for (std::size_t i = 0; i < queueCount; i++)
+	{
+		std::lock_guard<std::mutex> lock(subQueues[i].mutex);
+		if (!subQueues[i].heap.empty())
+		{
+			return takeTop(subQueues[i]);
+		}
+	}
+	return std::nullopt;
+}
@@ -0,0 +1,392 @@
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <mutex>
+#include <new>
+#include <utility>
+
+/**
+
+	@class   NodeCache
+	@brief   Per-thread caches of free node memory, shared by all containers with the same node type
+
+	@details ~ When a producer thread allocates nodes and a consumer thread frees them, every free goes through the heap's
+			   slow cross-thread path. NodeCache keeps freed nodes in small per-thread magazines instead: allocate() and
+			   deallocate() only touch the calling thread's two magazines, without locks or atomics.
+			   When both magazines are empty (or both are full) a whole magazine is swapped with a global depot under a
+			   mutex, so the consumer's freed nodes travel back to the producer MagazineSize at a time.
+			   The depot holds at most DepotLimit full magazines, beyond that freed nodes go back to the heap.
+			   A thread's magazines are handed to the depot when the thread exits. The depot itself is never destroyed,
+			   so containers destroyed during static destruction can still free their nodes; trim() returns it's nodes to the heap.
+	@tparam  TNode - node type, memory is handed out uninitialised for exactly one TNode
+
+**/
+template<typename TNode>
+class NodeCache
+{
+public:
+	// nodes moved between a thread and the depot at once
+	static constexpr std::size_t MagazineSize = 64;
+
+	// full magazines kept by the depot
+	static constexpr std::size_t DepotLimit = 256;
+
+	/**
+		@brief  Get memory for one node
+
+		Performs in O(1) constant time, taking the depot's mutex once every MagazineSize calls at most
+		@exception std::bad_alloc if the heap is exhausted
+		@retval void* memory for a TNode
+	**/
+	static void* allocate();
+
+	/**
+		@brief Give back memory from allocate(), on any thread
+
+		Performs in O(1) constant time, taking the depot's mutex once every MagazineSize calls at most
+		@param memory - memory returned by allocate(), the node must already be destroyed
+	**/
+	static void deallocate(void* memory) noexcept;
+
+	/**
+		@brief  Number of free nodes held by the depot, not counting the per-thread magazines
+	**/
+	static std::size_t depotNodes();
+
+	/**
+		@brief Return the free nodes held by the depot to the heap
+	**/
+	static void trim() noexcept;
+
+private:
+	struct Magazine
+	{
+		Magazine* next;
+		std::size_t count;
+		void* nodes[MagazineSize];
+	};
+
+	struct Depot
+	{
+		std::mutex mutex;
+		// magazines holding nodes, partially filled ones included
+		Magazine* full = nullptr;
+		std::size_t fullCount = 0;
+		// magazines without nodes, kept so threads need not allocate new ones
+		Magazine* empty = nullptr;
+	};
+
+	enum class CacheState : unsigned char
+	{
+		// the thread has not used the cache yet
+		Unused,
+		Active,
+		// the thread is exiting, it's magazines are gone and nodes bypass the cache
+		Retired
+	};
+
+	// trivially destructible, so it stays usable until the thread's storage is gone
+	struct ThreadCache
+	{
+		Magazine* loaded;
+		Magazine* previous;
+		CacheState state;
+	};
+
+	// hands the thread's magazines to the depot on thread exit
+	struct ThreadGuard
+	{
+		~ThreadGuard();
+	};
+
+	static inline thread_local ThreadCache cache{ nullptr, nullptr, CacheState::Unused };
+
+	static Depot& depot();
+
+	// Give the thread it's magazines, or report false when it is exiting
+	static bool activate();
+
+	static Magazine* newMagazine();
+	static void* newNode();
+	static void deleteNode(void* memory) noexcept;
+
+	static void* allocateSlow();
+	static void deallocateSlow(void* memory) noexcept;
+
+	// Depot transfers, all take the depot's mutex; magazines are singly linked through next
+	// Trade an empty magazine for a full one, nullptr if the depot has none
+	static Magazine* takeFull(Magazine* empty) noexcept;
+	// Trade a full magazine for an empty one; when the depot is full the magazine comes back emptied into the heap
+	static Magazine* putFull(Magazine* full) noexcept;
+	static void putEmpty(Magazine* empty) noexcept;
+};
+
+template<typename TNode>
+inline void* NodeCache<TNode>::allocate()
+{
+	auto loaded = cache.loaded;
+	if (loaded != nullptr && loaded->count > 0)
+	{
+		return loaded->nodes[--loaded->count];
+	}
+	return allocateSlow();
+}
+
+template<typename TNode>
+inline void NodeCache<TNode>::deallocate(void* memory) noexcept
+{
+	auto loaded = cache.loaded;
+	if (loaded != nullptr && loaded->count < MagazineSize)
+	{
+		loaded->nodes[loaded->count++] = memory;
+		return;
+	}
+	deallocateSlow(memory);
+}
+
+template<typename TNode>
+inline std::size_t NodeCache<TNode>::depotNodes()
+{
+	auto& d = depot();
+	std::lock_guard<std::mutex> lock(d.mutex);
+	std::size_t nodes = 0;
+	for (auto m = d.full; m != nullptr; m = m->next)
+	{
+		nodes += m->count;
+	}
+	return nodes;
+}
+
+template<typename TNode>
+inline void NodeCache<TNode>::trim() noexcept
+{
+	auto& d = depot();
+	Magazine* full;
+	Magazine* empty;
+	{
+		std::lock_guard<std::mutex> lock(d.mutex);
+		full = std::exchange(d.full, nullptr);
+		empty = std::exchange(d.empty, nullptr);
+		d.fullCount = 0;
+	}
+
+	while (full != nullptr)
+	{
+		auto next = full->next;
+		for (std::size_t i = 0; i < full->count; i++)
+		{
+			deleteNode(full->nodes[i]);
+		}
+		delete full;
+		full = next;
+	}
+	while (empty != nullptr)
+	{
+		delete std::exchange(empty, empty->next);
+	}
+}
+
+template<typename TNode>
+inline NodeCache<TNode>::ThreadGuard::~ThreadGuard()
+{
+	if (cache.state == CacheState::Active)
+	{
+		for (auto magazine : { cache.loaded, cache.previous })
+		{
+			putEmpty(magazine->count > 0 ? putFull(magazine) : magazine);
+		}
+	}
+	cache.loaded = nullptr;
+	cache.previous = nullptr;
+	cache.state = CacheState::Retired;
+}
+
+template<typename TNode>
+inline NodeCache<TNode>::Depot& NodeCache<TNode>::depot()
+{
+	// deliberately leaked, see the class description
+	static auto instance = new Depot();
+	return *instance;
+}
+
+template<typename TNode>
+inline bool NodeCache<TNode>::activate()
+{
+	if (cache.state == CacheState::Retired)
+	{
+		return false;
+	}
+
+	// constructed on the thread's first use, destroyed when the thread exits
+	thread_local ThreadGuard guard;
+	(void)guard;
+
+	cache.loaded = newMagazine();
+	try
+	{
+		cache.previous = newMagazine();
+	}
+	catch (...)
+	{
+		putEmpty(std::exchange(cache.loaded, nullptr));
+		throw;
+	}
+	cache.state = CacheState::Active;
+	return true;
+}
+
+template<typename TNode>
+inline NodeCache<TNode>::Magazine* NodeCache<TNode>::newMagazine()
+{
+	{
+		auto& d = depot();
+		std::lock_guard<std::mutex> lock(d.mutex);
+		if (auto magazine = d.empty)
+		{
+			d.empty = magazine->next;
+			return magazine;
+		}
+	}
+	auto magazine = new Magazine;
+	magazine->next = nullptr;
+	magazine->count = 0;
+	return magazine;
+}
+
+template<typename TNode>
+inline void* NodeCache<TNode>::newNode()
+{
+	return ::operator new(sizeof(TNode), std::align_val_t(alignof(TNode)));
+}
+
+template<typename TNode>
+inline void NodeCache<TNode>::deleteNode(void* memory) noexcept
+{
+	::operator delete(memory, std::align_val_t(alignof(TNode)));
+}
+
+template<typename TNode>
+inline void* NodeCache<TNode>::allocateSlow()
+{
+	if (cache.state != CacheState::Active && !activate())
+	{
+		return newNode();
+	}
+
+	if (cache.previous->count > 0)
+	{
+		std::swap(cache.loaded, cache.previous);
+		return cache.loaded->nodes[--cache.loaded->count];
+	}
+
+	// both magazines are empty: trade one for a full magazine of the depot
+	if (auto full = takeFull(cache.previous))
+	{
+		cache.previous = cache.loaded;
+		cache.loaded = full;
+		return cache.loaded->nodes[--cache.loaded->count];
+	}
+	return newNode();
+}
+
+template<typename TNode>
+inline void NodeCache<TNode>::deallocateSlow(void* memory) noexcept
+{
+	if (cache.state != CacheState::Active)
+	{
+		bool active = false;
+		try
+		{
+			active = activate();
+		}
+		catch (...)
+		{
+		}
+		if (!active)
+		{
+			deleteNode(memory);
+			return;
+		}
+	}
+
+	if (cache.previous->count < MagazineSize)
+	{
+		std::swap(cache.loaded, cache.previous);
+	}
+	else
+	{
+		// both magazines are full: hand one to the depot, it returns an empty one
+		auto empty = putFull(cache.previous);
+		cache.previous = cache.loaded;
+		cache.loaded = empty;
+	}
+	cache.loaded->nodes[cache.loaded->count++] = memory;
+}
+
+template<typename TNode>
+inline NodeCache<TNode>::Magazine* NodeCache<TNode>::takeFull(Magazine* empty) noexcept
+{
+	auto& d = depot();
+	std::lock_guard<std::mutex> lock(d.mutex);
+	auto full = d.full;
+	if (full == nullptr)
+	{
+		return nullptr;
+	}
+	d.full = full->next;
+	d.fullCount--;
+	empty->next = d.empty;
+	d.empty = empty;
+	return full;
+}
+
+template<typename TNode>
+inline NodeCache<TNode>::Magazine* NodeCache<TNode>::putFull(Magazine* full) noexcept
+{
+	auto& d = depot();
+	{
+		std::lock_guard<std::mutex> lock(d.mutex);
+		if (d.fullCount < DepotLimit)
+		{
+			auto spare = d.empty;
+			if (spare != nullptr)
+			{
+				d.empty = spare->next;
+			}
+			else
+			{
+				// only until enough magazines circulate between the threads
+				spare = new (std::nothrow) Magazine;
+			}
+
+			if (spare != nullptr)
+			{
+				full->next = d.full;
+				d.full = full;
+				d.fullCount++;
+				spare->next = nullptr;
+				spare->count = 0;
+				return spare;
+			}
+		}
+	}
+
+	// the depot is full, the nodes go back to the heap
+	for (std::size_t i = 0; i < full->count; i++)
+	{
+		deleteNode(full->nodes[i]);
+	}
+	full->count = 0;
+	return full;
+}
+
+template<typename TNode>
+inline void NodeCache<TNode>::putEmpty(Magazine* empty) noexcept
+{
+	auto& d = depot();
+	std::lock_guard<std::mutex> lock(d.mutex);
+	empty->count = 0;
+	empty->next = d.empty;
+	d.empty = empty;
+}
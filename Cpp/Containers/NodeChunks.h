@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/**
+
+	@class   NodeChunks
+	@brief   Owner of the node arrays behind a container's own free list
+
+	@details ~ Containers that recycle their nodes through a free list linked by the nodes' next pointers take new
+			   nodes from grow() whenever the free list runs dry. Chunks grow geometrically so allocations become
+			   rare, capped at MaxChunk nodes, and are only freed with the NodeChunks object.
+	@tparam  TNode - node type, default constructible with a next member that can point at a TNode
+
+**/
+template<typename TNode>
+class NodeChunks
+{
+public:
+	// nodes of the first chunk
+	static constexpr std::size_t MinChunk = 64;
+	// largest chunk, keeps single allocations reasonable
+	static constexpr std::size_t MaxChunk = 65536;
+
+	/**
+		@brief Construct without any chunk, no memory is allocated until the first grow()
+	**/
+	NodeChunks() noexcept;
+
+	NodeChunks(const NodeChunks&) = delete;
+	NodeChunks& operator=(const NodeChunks&) = delete;
+
+	/**
+		@brief  Allocate the next chunk
+
+		Performs in O(k) linear time, where k = the size of the new chunk
+		@exception std::bad_alloc if the chunk cannot be allocated, nothing changes then
+		@retval TNode* first node of the chunk, it's nodes are linked through next and the last one's next is nullptr
+	**/
+	TNode* grow();
+
+	/**
+		@brief  Number of nodes in all chunks
+	**/
+	std::size_t capacity() const noexcept;
+
+private:
+	std::vector<std::unique_ptr<TNode[]>> chunks;
+	std::size_t nodes;
+};
+
+template<typename TNode>
+inline NodeChunks<TNode>::NodeChunks() noexcept
+	: chunks()
+	, nodes(0)
+{}
+
+template<typename TNode>
+inline TNode* NodeChunks<TNode>::grow()
+{
+	std::size_t chunkSize = nodes < MinChunk ? MinChunk : (nodes < MaxChunk ? nodes : MaxChunk);
+	auto chunk = std::make_unique<TNode[]>(chunkSize);
+	for (std::size_t i = 0; i + 1 < chunkSize; i++)
+	{
+		chunk[i].next = &chunk[i + 1];
+	}
+	chunk[chunkSize - 1].next = nullptr;
+
+	// the chunk stays owned by the unique_ptr until the vector holds it
+	chunks.push_back(std::move(chunk));
+	nodes += chunkSize;
+	return chunks.back().get();
+}
+
+template<typename TNode>
+inline std::size_t NodeChunks<TNode>::capacity() const noexcept
+{
+	return nodes;
+}
@@ -0,0 +1,281 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+/**
+
+	@class   NodePool
+	@brief   Fixed-size object pool for container nodes
+
+	@details ~ Nodes are carved out of blocks, so n nodes cost about n / NodesPerBlock heap allocations instead of n,
+			   carry no per-allocation heap header, and nodes created together sit next to each other in memory.
+			   Blocks start small and double in size up to NodesPerBlock nodes, so a pool holding a handful of nodes
+			   stays small too. Destroyed nodes go onto a free list and are reused by the next create().
+			   Blocks are only returned to the heap by release() or when the pool is destroyed.
+			   An empty pool can be constructed, moved and destroyed in constant expressions.
+	@tparam  TNode         - node type
+	@tparam  NodesPerBlock - largest number of nodes allocated at once when the pool runs out
+
+**/
+template<typename TNode, std::size_t NodesPerBlock = 256>
+class NodePool
+{
+public:
+	/**
+		@brief Construct an empty pool, no memory is allocated until the first create()
+	**/
+	constexpr NodePool() noexcept;
+	constexpr ~NodePool();
+
+	NodePool(const NodePool&) = delete;
+	NodePool& operator=(const NodePool&) = delete;
+
+	constexpr NodePool(NodePool&& other) noexcept;
+	constexpr NodePool& operator=(NodePool&& other) noexcept;
+
+	/**
+		@brief  Construct a node in pool memory
+
+		Performs in O(1) constant time
+		@param  args - arguments forwarded to the TNode constructor
+		@retval TNode* the new node
+	**/
+	template<typename... TArgs>
+	TNode* create(TArgs&&... args);
+
+	/**
+		@brief Destroy a node created by this pool and put it's memory back on the free list
+
+		Performs in O(1) constant time
+		@param node - node to destroy
+	**/
+	void destroy(TNode* node) noexcept;
+
+	/**
+		@brief  Get memory for n nodes in one contiguous run, so a whole chain can be filled in at once
+
+		The nodes of the run sit in memory in the order they are filled in. The caller constructs node i at
+		run + i, each of them is given back with destroy() like any other node.
+		Performs in O(1) constant time, plus O(NodesPerBlock) when the newest block has too few unused slots
+		@exception std::bad_alloc if no memory can be allocated
+		@param  n - number of nodes, at least 1
+		@retval TNode* uninitialized memory for n nodes
+	**/
+	TNode* allocateRun(std::size_t n);
+
+	/**
+		@brief Return all blocks to the heap without running node destructors
+
+		Every node created by the pool is invalid afterwards; only call this when the nodes have been destroyed
+		already or when TNode is trivially destructible.
+	**/
+	constexpr void release() noexcept;
+
+	/**
+		@brief  Bytes of heap memory held by the pool
+	**/
+	std::size_t memoryUsage() const noexcept;
+
+private:
+	union Slot
+	{
+		Slot* nextFree;
+		alignas(TNode) unsigned char storage[sizeof(TNode)];
+	};
+
+	// size of the first block, following blocks double up to NodesPerBlock
+	static constexpr std::size_t FirstBlockNodes = NodesPerBlock < 8 ? NodesPerBlock : 8;
+
+	// block header, the block's slots follow it in the same allocation
+	struct alignas(Slot) Block
+	{
+		Block* next;
+		std::size_t size;
+
+		Slot* slots() noexcept
+		{
+			return reinterpret_cast<Slot*>(this + 1);
+		}
+	};
+
+	Block* blocks;
+	std::size_t bytes;
+
+	// destroyed nodes, ready for reuse
+	Slot* freeList;
+
+	// never used slots of the newest block
+	Slot* unused;
+	Slot* unusedEnd;
+
+	// Get memory for one node
+	void* allocate();
+	// Allocate the next block, with at least minSize slots, and make it's slots the unused ones
+	void addBlock(std::size_t minSize);
+};
+
+template<typename TNode, std::size_t NodesPerBlock>
+inline constexpr NodePool<TNode, NodesPerBlock>::NodePool() noexcept
+	: blocks(nullptr)
+	, bytes(0)
+	, freeList(nullptr)
+	, unused(nullptr)
+	, unusedEnd(nullptr)
+{}
+
+template<typename TNode, std::size_t NodesPerBlock>
+inline constexpr NodePool<TNode, NodesPerBlock>::~NodePool()
+{
+	release();
+}
+
+template<typename TNode, std::size_t NodesPerBlock>
+inline constexpr NodePool<TNode, NodesPerBlock>::NodePool(NodePool&& other) noexcept
+	: blocks(std::exchange(other.blocks, nullptr))
+	, bytes(std::exchange(other.bytes, 0))
+	, freeList(std::exchange(other.freeList, nullptr))
+	, unused(std::exchange(other.unused, nullptr))
+	, unusedEnd(std::exchange(other.unusedEnd, nullptr))
+{}
+
+template<typename TNode, std::size_t NodesPerBlock>
+inline constexpr NodePool<TNode, NodesPerBlock>& NodePool<TNode, NodesPerBlock>::operator=(NodePool&& other) noexcept
+{
+	if (this != &other)
+	{
+		release();
+		blocks = std::exchange(other.blocks, nullptr);
+		bytes = std::exchange(other.bytes, 0);
+		freeList = std::exchange(other.freeList, nullptr);
+		unused = std::exchange(other.unused, nullptr);
+		unusedEnd = std::exchange(other.unusedEnd, nullptr);
+	}
+	return *this;
+}
+
+template<typename TNode, std::size_t NodesPerBlock>
+template<typename... TArgs>
+inline TNode* NodePool<TNode, NodesPerBlock>::create(TArgs&&... args)
+{
+	auto memory = allocate();
+	try
+	{
+		return ::new (memory) TNode(std::forward<TArgs>(args)...);
+	}
+	catch (...)
+	{
+		auto slot = static_cast<Slot*>(memory);
+		slot->nextFree = freeList;
+		freeList = slot;
+		throw;
+	}
+}
+
+template<typename TNode, std::size_t NodesPerBlock>
+inline void NodePool<TNode, NodesPerBlock>::destroy(TNode* node) noexcept
+{
+	node->~TNode();
+	auto slot = reinterpret_cast<Slot*>(node);
+	slot->nextFree = freeList;
+	freeList = slot;
+}
+
+template<typename TNode, std::size_t NodesPerBlock>
+inline constexpr void NodePool<TNode, NodesPerBlock>::release() noexcept
+{
+	while (blocks != nullptr)
+	{
+		auto next = blocks->next;
+		::operator delete(blocks, std::align_val_t(alignof(Block)));
+		blocks = next;
+	}
+	bytes = 0;
+	freeList = nullptr;
+	unused = nullptr;
+	unusedEnd = nullptr;
+}
+
+template<typename TNode, std::size_t NodesPerBlock>
+inline std::size_t NodePool<TNode, NodesPerBlock>::memoryUsage() const noexcept
+{
+	return bytes;
+}
+
+template<typename TNode, std::size_t NodesPerBlock>
+inline void* NodePool<TNode, NodesPerBlock>::allocate()
+{
+	if (freeList != nullptr)
+	{
+		auto slot = freeList;
+		freeList = slot->nextFree;
+		return slot->storage;
+	}
+
+	if (unused == unusedEnd)
+	{
+		addBlock(1);
+	}
+	return (unused++)->storage;
+}
+
+template<typename TNode, std::size_t NodesPerBlock>
+inline TNode* NodePool<TNode, NodesPerBlock>::allocateRun(std::size_t n)
+{
+	// node i of the run is addressed as run + i
+	static_assert(sizeof(Slot) == sizeof(TNode), "a run needs slots the size of a node");
+
+	if (static_cast<std::size_t>(unusedEnd - unused) < n)
+	{
+		if (n >= NodesPerBlock)
+		{
+			// a block of it's own, linked behind the newest block so that one keeps handing out it's unused slots
+			auto blockBytes = sizeof(Block) + n * sizeof(Slot);
+			auto block = static_cast<Block*>(::operator new(blockBytes, std::align_val_t(alignof(Block))));
+			block->size = n;
+			if (blocks == nullptr)
+			{
+				block->next = nullptr;
+				blocks = block;
+			}
+			else
+			{
+				block->next = blocks->next;
+				blocks->next = block;
+			}
+			bytes += blockBytes;
+			return reinterpret_cast<TNode*>(block->slots());
+		}
+
+		// the rest of the newest block is kept on the free list
+		while (unused != unusedEnd)
+		{
+			unused->nextFree = freeList;
+			freeList = unused++;
+		}
+		addBlock(n);
+	}
+
+	auto run = unused;
+	unused += n;
+	return reinterpret_cast<TNode*>(run);
+}
+
+template<typename TNode, std::size_t NodesPerBlock>
+inline void NodePool<TNode, NodesPerBlock>::addBlock(std::size_t minSize)
+{
+	auto size = blocks == nullptr ? FirstBlockNodes : (blocks->size * 2 < NodesPerBlock ? blocks->size * 2 : NodesPerBlock);
+	if (size < minSize)
+	{
+		size = minSize;
+	}
+	auto blockBytes = sizeof(Block) + size * sizeof(Slot);
+	auto block = static_cast<Block*>(::operator new(blockBytes, std::align_val_t(alignof(Block))));
+	block->next = blocks;
+	block->size = size;
+	blocks = block;
+	bytes += blockBytes;
+	unused = block->slots();
+	unusedEnd = unused + size;
+}
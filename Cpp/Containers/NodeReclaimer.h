@@ -0,0 +1,242 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+/**
+	@enum  ReclaimMode
+	@brief How a NodeReclaimer frees the node chains handed to it
+**/
+enum class ReclaimMode
+{
+	// a worker thread owned by the reclaimer frees chains as soon as they are retired
+	Background,
+	// chains are freed a bounded number of nodes at a time by calls to collect()
+	Incremental
+};
+
+/**
+
+	@class   NodeReclaimer
+	@brief   Frees detached node chains away from the thread that dropped them
+
+	@details ~ A container that is cleared or destroyed can retire() it's whole node chain in O(1) instead of freeing every node,
+			   so the latency of clear() and of the destructor no longer depends on the number of nodes.
+			   The reclaimer then frees the chain either on it's own worker thread (ReclaimMode::Background),
+			   or at most budget() nodes per collect() call (ReclaimMode::Incremental), which containers call on
+			   their later operations. Chains are type-erased: the container passes a release function that knows it's node type.
+			   Node destructors (and so TValue destructors) run on whichever thread frees the chain.
+			   Any chains still pending are freed by the reclaimer's destructor, so it must outlive the containers using it.
+
+**/
+class NodeReclaimer
+{
+public:
+	/**
+		@brief  Frees at most budget nodes from the front of a chain
+		@param  chain  - first node of the chain, updated to the first node not freed (nullptr once the chain is gone)
+		@param  budget - maximum number of nodes to free
+		@retval size_t number of nodes freed
+	**/
+	using ReleaseFunction = std::size_t(*)(void*& chain, std::size_t budget);
+
+	/**
+		@brief Construct a reclaimer
+		@param mode   - whether chains are freed by a worker thread or by collect() calls
+		@param budget - maximum number of nodes freed per collect() call (ReclaimMode::Incremental only)
+	**/
+	explicit NodeReclaimer(ReclaimMode mode = ReclaimMode::Background, std::size_t budget = 256);
+
+	/**
+		@brief Frees all pending chains and stops the worker thread
+	**/
+	~NodeReclaimer();
+
+	NodeReclaimer(const NodeReclaimer&) = delete;
+	NodeReclaimer& operator=(const NodeReclaimer&) = delete;
+
+	/**
+		@brief Take ownership of a detached node chain
+
+		Performs in O(1) constant time
+		@param chain   - first node of the chain
+		@param release - function that frees nodes of the chain
+	**/
+	void retire(void* chain, ReleaseFunction release);
+
+	/**
+		@brief  Free up to budget() retired nodes, does nothing in ReclaimMode::Background
+
+		Performs in O(budget) time
+		@retval size_t number of nodes freed
+	**/
+	std::size_t collect();
+
+	/**
+		@brief  Free all retired nodes now, on the calling thread
+		@retval size_t number of nodes freed
+	**/
+	std::size_t drain();
+
+	/**
+		@brief  Number of retired chains that are not completely freed yet
+	**/
+	std::size_t pending() const;
+
+	ReclaimMode mode() const noexcept;
+	std::size_t budget() const noexcept;
+
+private:
+	struct Chain
+	{
+		void* head;
+		ReleaseFunction release;
+	};
+
+	const ReclaimMode reclaimMode;
+	const std::size_t nodeBudget;
+
+	mutable std::mutex mutex;
+	std::condition_variable wake;
+	std::deque<Chain> chains;
+	bool stopping;
+
+	std::thread worker;
+
+	// Take the oldest chain and free up to budget nodes of it, putting the rest back
+	std::size_t releaseSome(std::size_t budget);
+
+	// Worker thread loop for ReclaimMode::Background
+	void run();
+};
+
+inline NodeReclaimer::NodeReclaimer(ReclaimMode mode, std::size_t budget)
+	: reclaimMode(mode)
+	, nodeBudget(budget > 0 ? budget : 1)
+	, mutex()
+	, wake()
+	, chains()
+	, stopping(false)
+	, worker()
+{
+	if (reclaimMode == ReclaimMode::Background)
+	{
+		worker = std::thread(&NodeReclaimer::run, this);
+	}
+}
+
+inline NodeReclaimer::~NodeReclaimer()
+{
+	if (worker.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		wake.notify_one();
+		worker.join();
+	}
+	drain();
+}
+
+inline void NodeReclaimer::retire(void* chain, ReleaseFunction release)
+{
+	if (chain == nullptr)
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		chains.push_back(Chain{ chain, release });
+	}
+	if (reclaimMode == ReclaimMode::Background)
+	{
+		wake.notify_one();
+	}
+}
+
+inline std::size_t NodeReclaimer::collect()
+{
+	if (reclaimMode == ReclaimMode::Background)
+	{
+		return 0;
+	}
+	return releaseSome(nodeBudget);
+}
+
+inline std::size_t NodeReclaimer::drain()
+{
+	std::size_t freed = 0;
+	while (true)
+	{
+		auto released = releaseSome(static_cast<std::size_t>(-1));
+		if (released == 0)
+		{
+			return freed;
+		}
+		freed += released;
+	}
+}
+
+inline std::size_t NodeReclaimer::pending() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return chains.size();
+}
+
+inline ReclaimMode NodeReclaimer::mode() const noexcept
+{
+	return reclaimMode;
+}
+
+inline std::size_t NodeReclaimer::budget() const noexcept
+{
+	return nodeBudget;
+}
+
+inline std::size_t NodeReclaimer::releaseSome(std::size_t budget)
+{
+	Chain chain;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (chains.empty())
+		{
+			return 0;
+		}
+		chain = chains.front();
+		chains.pop_front();
+	}
+
+	// free outside the lock so retire() never waits for node destructors
+	auto freed = chain.release(chain.head, budget);
+
+	if (chain.head != nullptr)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		chains.push_front(chain);
+	}
+	return freed;
+}
+
+inline void NodeReclaimer::run()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true)
+	{
+		wake.wait(lock, [this] { return stopping || !chains.empty(); });
+		if (stopping)
+		{
+			// the destructor drains what is left
+			return;
+		}
+
+		lock.unlock();
+		// free in slices so a stop request is noticed between them
+		releaseSome(nodeBudget);
+		lock.lock();
+	}
+}
@@ -0,0 +1,641 @@
+#pragma once
+
+#include <string>
+#include <sstream>
+#include <stdexcept>
+#include <iterator>
+
+/**
+	@enum  ReorderPolicy
+	@brief Heuristic applied by SelfOrganizingList when a lookup finds a value
+**/
+enum class ReorderPolicy
+{
+	// found node is relinked at the head of the list
+	MoveToFront,
+	// found node swaps places with its predecessor
+	Transpose,
+	// nodes are kept ordered by access count, the found node moves ahead of all nodes with a lower count
+	Count
+};
+
+/**
+
+	@class   SelfOrganizingList
+	@brief   Doubly-linked list that reorders itself on lookup so frequently accessed values migrate towards the head
+
+	@details ~ Follows the same push/pop/front/back conventions as LinkedList and adds find()/contains().
+			   Every successful lookup applies the configured ReorderPolicy by relinking the found node in O(1),
+			   so skewed (e.g. Zipfian) access patterns end up with the hot values a few probes away from the head.
+			   Lookup statistics (number of lookups and nodes probed) are kept to measure the average probe length.
+	@tparam  TValue - type of list's values, must be equality comparable
+
+**/
+template<typename TValue>
+class SelfOrganizingList
+{
+public:
+	/**
+		@brief Construct an empty list
+		@param policy - reordering heuristic applied on successful lookups
+	**/
+	explicit SelfOrganizingList(ReorderPolicy policy = ReorderPolicy::MoveToFront) noexcept;
+	~SelfOrganizingList();
+
+	SelfOrganizingList(const SelfOrganizingList&) = delete;
+	SelfOrganizingList& operator=(const SelfOrganizingList&) = delete;
+
+	using value_type = TValue;
+	using pointer = value_type*;
+	using reference = value_type&;
+	using const_reference = const value_type&;
+	using const_pointer = const value_type*;
+	using size_type = std::size_t;
+	using difference_type = std::ptrdiff_t;
+
+	class iterator;
+
+	/**
+		@brief  Returns size of the list
+
+		Performs in O(1) constant time
+		@retval size_t count of values in the list
+	**/
+	size_type size() const noexcept;
+
+	/**
+		@brief  Determines if the list is empty, i.e. it contains no values
+
+		Performs in O(1) constant time
+		@retval bool true if the list is empty, false if the list contains nodes
+	**/
+	bool empty() const noexcept;
+
+	/**
+		@brief Add an element to the front of the list
+
+		Performs in O(1) constant time. With ReorderPolicy::Count the value is added after all accessed values instead,
+		which is O(n) in the worst case.
+		@param val - value to add
+	**/
+	void push_front(const TValue& val);
+
+	/**
+		 @brief Add an element to the end of the list
+
+		 Performs in O(1) constant time
+		 @param val - value to add
+	 **/
+	void push_back(const TValue& val);
+
+	/**
+		@brief  Return the value at the beginning of the list, without removing it from the list
+
+		Performs in O(1) constant time
+		@exception std::runtime_error if list is empty
+		@retval TValue value at the beginning of the list
+	**/
+	reference front();
+	const_reference front() const;
+
+	/**
+		@brief  Return the value at the end of the list, without removing it from the list
+
+		Performs in O(1) constant time
+		@exception std::runtime_error if list is empty
+		@retval TValue value at the end of the list
+	**/
+	reference back();
+	const_reference back() const;
+
+	/**
+		@brief Removes the value at the beginning of the list and returns it
+
+		Performs in O(1) constant time
+		@exception std::runtime_error if list is empty
+		@retval TValue value at the beginning of the list
+	**/
+	value_type pop_front();
+
+	/**
+		@brief Removes the value at the end of the list and returns it
+
+		Performs in O(1) constant time
+		@exception std::runtime_error if list is empty
+		@retval TValue value at the end of the list
+	**/
+	value_type pop_back();
+
+	/**
+		@brief Removes all elements of the list
+
+		Performs in O(n) linear time, where n = the number of values in the list
+	**/
+	void clear();
+
+	/**
+		@brief  Search the list for a value and reorder the list according to the policy if it is found
+
+		Performs in O(k) time, where k = the position of the value in the list. The reordering itself is O(1).
+		@param  val - value to search for
+		@retval iterator pointing at the found value, or end() if the value is not in the list
+	**/
+	iterator find(const TValue& val);
+
+	/**
+		@brief  Determines if the list contains a value, reordering the list like find() does
+		@param  val - value to search for
+		@retval bool true if the value was found
+	**/
+	bool contains(const TValue& val);
+
+	/**
+		@brief Removes the value the iterator points at
+
+		Performs in O(1) constant time
+		@param pos - valid, dereferenceable iterator into this list
+	**/
+	void erase(iterator pos);
+
+	ReorderPolicy policy() const noexcept;
+
+	/**
+		@brief Change the reordering heuristic
+
+		Switching to ReorderPolicy::Count resets all access counts, the current order is kept.
+		@param policy - new reordering heuristic
+	**/
+	void setPolicy(ReorderPolicy policy) noexcept;
+
+	/**
+		@brief  Number of calls to find()/contains() since construction or the last resetStatistics()
+	**/
+	std::size_t lookups() const noexcept;
+
+	/**
+		@brief  Number of nodes compared by find()/contains() since construction or the last resetStatistics()
+	**/
+	std::size_t probes() const noexcept;
+
+	/**
+		@brief  Average count of nodes compared per lookup
+		@retval double probes() / lookups(), or 0 if no lookups were made
+	**/
+	double averageProbeLength() const noexcept;
+
+	void resetStatistics() noexcept;
+
+	iterator begin() noexcept;
+	iterator end() noexcept;
+
+	/**
+		@brief Get string representation of list suitable for display
+		@retval  - std::string representation of list
+	**/
+	std::string toString() const;
+
+private:
+	// forward declaration (implementation below)
+	struct Node;
+
+	Node* head;
+	Node* tail;
+
+	int count;
+
+	ReorderPolicy reorderPolicy;
+
+	std::size_t lookupCount;
+	std::size_t probeCount;
+
+	// Search without reordering, run = first node of the run of equal access counts containing the result
+	Node* findNode(const TValue& val, Node*& run);
+
+	// Apply the reordering policy to a node found by a lookup
+	void reorder(Node* node, Node* run);
+
+	// Link a detached node into the list BEFORE the given node (nullptr = at the end)
+	void linkBefore(Node* node, Node* before) noexcept;
+	// Detach a node from the list without freeing it
+	void unlink(Node* node) noexcept;
+
+	// Remove the given node (and free it's memory)
+	TValue removeNode(Node* node);
+};
+
+/**
+	@struct Node
+	@brief  Represents a node in the SelfOrganizingList
+	@tparam TValue - type of Node's values
+**/
+template<typename TValue>
+struct SelfOrganizingList<TValue>::Node
+{
+	explicit Node(const TValue& val)
+		: data(val)
+		, next(nullptr)
+		, prev(nullptr)
+		, hits(0)
+	{}
+
+	TValue data;
+	Node* next;
+	Node* prev;
+
+	// number of successful lookups of this node (ReorderPolicy::Count only)
+	std::size_t hits;
+};
+
+/**
+	@class  SelfOrganizingList::iterator
+	@brief  Forward iterator over a SelfOrganizingList, reordering by find() does not invalidate it
+**/
+template<typename TValue>
+class SelfOrganizingList<TValue>::iterator
+{
+public:
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = TValue;
+	using difference_type = std::ptrdiff_t;
+	using pointer = value_type*;
+	using reference = value_type&;
+
+	constexpr iterator() noexcept
+		: current(nullptr)
+	{}
+
+	reference operator*() const
+	{
+		return current->data;
+	}
+
+	pointer operator->() const
+	{
+		return &current->data;
+	}
+
+	iterator& operator++()
+	{
+		current = current->next;
+		return *this;
+	}
+
+	iterator operator++(int)
+	{
+		auto it = *this;
+		current = current->next;
+		return it;
+	}
+
+	bool operator==(const iterator& other) const
+	{
+		return current == other.current;
+	}
+
+	bool operator!=(const iterator& other) const
+	{
+		return !(*this == other);
+	}
+
+private:
+	Node* current;
+
+	constexpr explicit iterator(Node* current) noexcept
+		: current(current)
+	{}
+
+	friend class SelfOrganizingList<TValue>;
+};
+
+template<typename TValue>
+inline SelfOrganizingList<TValue>::SelfOrganizingList(ReorderPolicy policy) noexcept
+	: head(nullptr)
+	, tail(nullptr)
+	, count(0)
+	, reorderPolicy(policy)
+	, lookupCount(0)
+	, probeCount(0)
+{}
+
+template<typename TValue>
+inline SelfOrganizingList<TValue>::~SelfOrganizingList()
+{
+	clear();
+}
+
+template<typename TValue>
+inline std::size_t SelfOrganizingList<TValue>::size() const noexcept
+{
+	return count;
+}
+
+template<typename TValue>
+inline bool SelfOrganizingList<TValue>::empty() const noexcept
+{
+	return head == nullptr;
+}
+
+template<typename TValue>
+inline void SelfOrganizingList<TValue>::push_front(const TValue& val)
+{
+	auto newNode = new Node(val);
+	auto before = head;
+	if (reorderPolicy == ReorderPolicy::Count)
+	{
+		// keep the list ordered by access count: new values (0 hits) go behind all accessed values
+		while (before != nullptr && before->hits > 0)
+		{
+			before = before->next;
+		}
+	}
+	linkBefore(newNode, before);
+	count++;
+}
+
+template<typename TValue>
+inline void SelfOrganizingList<TValue>::push_back(const TValue& val)
+{
+	linkBefore(new Node(val), nullptr);
+	count++;
+}
+
+template<typename TValue>
+inline typename SelfOrganizingList<TValue>::reference SelfOrganizingList<TValue>::front()
+{
+	if (head == nullptr) throw std::runtime_error("list is empty");
+	return head->data;
+}
+
+template<typename TValue>
+inline typename SelfOrganizingList<TValue>::const_reference SelfOrganizingList<TValue>::front() const
+{
+	if (head == nullptr) throw std::runtime_error("list is empty");
+	return head->data;
+}
+
+template<typename TValue>
+inline typename SelfOrganizingList<TValue>::reference SelfOrganizingList<TValue>::back()
+{
+	if (tail == nullptr) throw std::runtime_error("list is empty");
+	return tail->data;
+}
+
+template<typename TValue>
+inline typename SelfOrganizingList<TValue>::const_reference SelfOrganizingList<TValue>::back() const
+{
+	if (tail == nullptr) throw std::runtime_error("list is empty");
+	return tail->data;
+}
+
+template<typename TValue>
+inline TValue SelfOrganizingList<TValue>::pop_front()
+{
+	return removeNode(head);
+}
+
+template<typename TValue>
+inline TValue SelfOrganizingList<TValue>::pop_back()
+{
+	return removeNode(tail);
+}
+
+template<typename TValue>
+inline void SelfOrganizingList<TValue>::clear()
+{
+	while (head != nullptr)
+	{
+		auto next = head->next;
+		delete head;
+		head = next;
+	}
+	tail = nullptr;
+	count = 0;
+}
+
+template<typename TValue>
+inline typename SelfOrganizingList<TValue>::iterator SelfOrganizingList<TValue>::find(const TValue& val)
+{
+	Node* run = nullptr;
+	auto node = findNode(val, run);
+	if (node != nullptr)
+	{
+		reorder(node, run);
+	}
+	return iterator(node);
+}
+
+template<typename TValue>
+inline bool SelfOrganizingList<TValue>::contains(const TValue& val)
+{
+	return find(val) != end();
+}
+
+template<typename TValue>
+inline void SelfOrganizingList<TValue>::erase(iterator pos)
+{
+	removeNode(pos.current);
+}
+
+template<typename TValue>
+inline ReorderPolicy SelfOrganizingList<TValue>::policy() const noexcept
+{
+	return reorderPolicy;
+}
+
+template<typename TValue>
+inline void SelfOrganizingList<TValue>::setPolicy(ReorderPolicy policy) noexcept
+{
+	if (policy == ReorderPolicy::Count && reorderPolicy != ReorderPolicy::Count)
+	{
+		// the list is not ordered by the stale counts, start over
+		for (auto n = head; n != nullptr; n = n->next)
+		{
+			n->hits = 0;
+		}
+	}
+	reorderPolicy = policy;
+}
+
+template<typename TValue>
+inline std::size_t SelfOrganizingList<TValue>::lookups() const noexcept
+{
+	return lookupCount;
+}
+
+template<typename TValue>
+inline std::size_t SelfOrganizingList<TValue>::probes() const noexcept
+{
+	return probeCount;
+}
+
+template<typename TValue>
+inline double SelfOrganizingList<TValue>::averageProbeLength() const noexcept
+{
+	if (lookupCount == 0)
+	{
+		return 0.0;
+	}
+	return static_cast<double>(probeCount) / static_cast<double>(lookupCount);
+}
+
+template<typename TValue>
+inline void SelfOrganizingList<TValue>::resetStatistics() noexcept
+{
+	lookupCount = 0;
+	probeCount = 0;
+}
+
+template<typename TValue>
+inline typename SelfOrganizingList<TValue>::iterator SelfOrganizingList<TValue>::begin() noexcept
+{
+	return iterator(head);
+}
+
+template<typename TValue>
+inline typename SelfOrganizingList<TValue>::iterator SelfOrganizingList<TValue>::end() noexcept
+{
+	return iterator(nullptr);
+}
+
+template<typename TValue>
+inline typename SelfOrganizingList<TValue>::Node* SelfOrganizingList<TValue>::findNode(const TValue& val, Node*& run)
+{
+	lookupCount++;
+
+	run = head;
+	for (auto n = head; n != nullptr; n = n->next)
+	{
+		probeCount++;
+		if (n->hits != run->hits)
+		{
+			// list is ordered by hits (Count policy), remember where the current run of equal counts begins
+			run = n;
+		}
+		if (n->data == val)
+		{
+			return n;
+		}
+	}
+	return nullptr;
+}
+
+template<typename TValue>
+inline void SelfOrganizingList<TValue>::reorder(Node* node, Node* run)
+{
+	switch (reorderPolicy)
+	{
+	case ReorderPolicy::MoveToFront:
+		if (node != head)
+		{
+			unlink(node);
+			linkBefore(node, head);
+		}
+		break;
+
+	case ReorderPolicy::Transpose:
+		if (node != head)
+		{
+			auto before = node->prev;
+			unlink(node);
+			linkBefore(node, before);
+		}
+		break;
+
+	case ReorderPolicy::Count:
+		// node now has more hits than every other node of its run, so it belongs in front of the run
+		node->hits++;
+		if (node != run)
+		{
+			unlink(node);
+			linkBefore(node, run);
+		}
+		break;
+	}
+}
+
+template<typename TValue>
+inline void SelfOrganizingList<TValue>::linkBefore(Node* node, Node* before) noexcept
+{
+	node->next = before;
+	if (before != nullptr)
+	{
+		node->prev = before->prev;
+		before->prev = node;
+	}
+	else
+	{
+		// new tail
+		node->prev = tail;
+		tail = node;
+	}
+
+	if (node->prev != nullptr)
+	{
+		node->prev->next = node;
+	}
+	else
+	{
+		// new head
+		head = node;
+	}
+}
+
+template<typename TValue>
+inline void SelfOrganizingList<TValue>::unlink(Node* node) noexcept
+{
+	if (node->next != nullptr)
+	{
+		node->next->prev = node->prev;
+	}
+	else
+	{
+		// removing the tail
+		tail = node->prev;
+	}
+
+	if (node->prev != nullptr)
+	{
+		node->prev->next = node->next;
+	}
+	else
+	{
+		// removing the head
+		head = node->next;
+	}
+
+	node->next = nullptr;
+	node->prev = nullptr;
+}
+
+template<typename TValue>
+inline TValue SelfOrganizingList<TValue>::removeNode(Node* node)
+{
+	if (head == nullptr) throw std::runtime_error("cannot remove from empty list");
+
+	unlink(node);
+	auto val = std::move(node->data);
+	delete node;
+
+	count--;
+
+	return val;
+}
+
+template<typename TValue>
+inline std::string SelfOrganizingList<TValue>::toString() const
+{
+	std::stringstream ss;
+
+	auto n = head;
+	while (n != nullptr)
+	{
+		ss << '[' << n->data << ']';
+		if (n->next != nullptr)
+		{
+			ss << "<->";
+		}
+		n = n->next;
+	}
+
+	return ss.str();
+}
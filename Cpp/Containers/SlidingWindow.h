@@ -0,0 +1,298 @@
+#pragma once
+
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include "LinkedList.h"
+
+/**
+
+	@class   SlidingWindow
+	@brief   FIFO window of values with O(1) min, max and aggregate queries
+
+	@details ~ Built on LinkedList. Values enter at the back and leave at the front, like a queue.
+			   min() and max() come from two monotonic LinkedLists that only keep values which can still become
+			   the window's minimum/maximum, so each value is added and removed from them at most once.
+			   aggregate() combines all values with any associative operation (it does not need an inverse,
+			   so max, gcd or matrix products work as well as sums): the window is split into a front part, which keeps
+			   the combination of every suffix, and a back part, which keeps one running combination. When the front part
+			   runs out, the back part is turned into a new front part in one pass. Every operation is amortized O(1).
+	@tparam  TValue   - type of window's values
+	@tparam  TCombine - associative binary operation used by aggregate()
+	@tparam  TCompare - strict weak ordering used by min() and max()
+
+**/
+template<typename TValue, typename TCombine = std::plus<TValue>, typename TCompare = std::less<TValue>>
+class SlidingWindow
+{
+public:
+	/**
+		@brief Construct an empty window
+		@param combine - associative operation used by aggregate()
+		@param compare - ordering used by min() and max()
+	**/
+	explicit SlidingWindow(TCombine combine = TCombine(), TCompare compare = TCompare());
+
+	using value_type = TValue;
+	using const_reference = const value_type&;
+	using size_type = std::size_t;
+
+	/**
+		@brief  Returns number of values in the window
+
+		Performs in O(1) constant time
+	**/
+	size_type size() const noexcept;
+
+	/**
+		@brief  Determines if the window is empty
+
+		Performs in O(1) constant time
+	**/
+	bool empty() const noexcept;
+
+	/**
+		@brief Add a value to the back of the window
+
+		Performs in O(1) amortized constant time
+		@param val - value to add
+	**/
+	void push_back(const TValue& val);
+
+	/**
+		@brief Remove the oldest value from the window and return it
+
+		Performs in O(1) amortized constant time
+		@exception std::runtime_error if the window is empty
+	**/
+	value_type pop_front();
+
+	/**
+		@brief  Return the oldest value in the window
+		@exception std::runtime_error if the window is empty
+	**/
+	const_reference front() const;
+
+	/**
+		@brief  Return the newest value in the window
+		@exception std::runtime_error if the window is empty
+	**/
+	const_reference back() const;
+
+	/**
+		@brief  Smallest value in the window according to TCompare
+
+		Performs in O(1) constant time
+		@exception std::runtime_error if the window is empty
+	**/
+	const_reference min() const;
+
+	/**
+		@brief  Largest value in the window according to TCompare
+
+		Performs in O(1) constant time
+		@exception std::runtime_error if the window is empty
+	**/
+	const_reference max() const;
+
+	/**
+		@brief  All values of the window combined with TCombine, oldest first
+
+		Performs in O(1) constant time
+		@exception std::runtime_error if the window is empty
+	**/
+	value_type aggregate() const;
+
+	/**
+		@brief  Same as aggregate(), the sum of the window for the default TCombine
+		@exception std::runtime_error if the window is empty
+	**/
+	value_type sum() const;
+
+	/**
+		@brief Removes all values from the window
+	**/
+	void clear();
+
+	/**
+		@brief Get string representation of the window's values suitable for display
+	**/
+	std::string toString() const;
+
+private:
+	// all values, oldest first
+	LinkedList<TValue> values;
+
+	// candidates for min()/max(), min()/max() is always the front
+	LinkedList<TValue> minimums;
+	LinkedList<TValue> maximums;
+
+	// combination of the front part's value at the same position and every front part value after it
+	LinkedList<TValue> frontAggregates;
+	// combination of the values pushed since the last flip, valid if backCount > 0
+	TValue backAggregate;
+	size_type backCount;
+
+	TCombine combine;
+	TCompare compare;
+
+	// Turn the back part into the front part, computing it's suffix combinations
+	void flip();
+};
+
+template<typename TValue, typename TCombine, typename TCompare>
+inline SlidingWindow<TValue, TCombine, TCompare>::SlidingWindow(TCombine combine, TCompare compare)
+	: values()
+	, minimums()
+	, maximums()
+	, frontAggregates()
+	, backAggregate()
+	, backCount(0)
+	, combine(combine)
+	, compare(compare)
+{}
+
+template<typename TValue, typename TCombine, typename TCompare>
+inline std::size_t SlidingWindow<TValue, TCombine, TCompare>::size() const noexcept
+{
+	return values.size();
+}
+
+template<typename TValue, typename TCombine, typename TCompare>
+inline bool SlidingWindow<TValue, TCombine, TCompare>::empty() const noexcept
+{
+	return values.empty();
+}
+
+template<typename TValue, typename TCombine, typename TCompare>
+inline void SlidingWindow<TValue, TCombine, TCompare>::push_back(const TValue& val)
+{
+	values.push_back(val);
+
+	// values that are larger (smaller) than the new value can never be the minimum (maximum) again,
+	// equal values are kept so every copy leaves with it's own pop_front()
+	while (!minimums.empty() && compare(val, minimums.back()))
+	{
+		minimums.pop_back();
+	}
+	minimums.push_back(val);
+
+	while (!maximums.empty() && compare(maximums.back(), val))
+	{
+		maximums.pop_back();
+	}
+	maximums.push_back(val);
+
+	backAggregate = backCount > 0 ? combine(backAggregate, val) : val;
+	backCount++;
+}
+
+template<typename TValue, typename TCombine, typename TCompare>
+inline TValue SlidingWindow<TValue, TCombine, TCompare>::pop_front()
+{
+	if (values.empty()) throw std::runtime_error("window is empty");
+
+	if (frontAggregates.empty())
+	{
+		flip();
+	}
+	frontAggregates.pop_front();
+
+	auto val = values.pop_front();
+
+	// the oldest candidate is equivalent to val exactly when it is val (or an equal copy pushed after it)
+	if (!compare(minimums.front(), val) && !compare(val, minimums.front()))
+	{
+		minimums.pop_front();
+	}
+	if (!compare(maximums.front(), val) && !compare(val, maximums.front()))
+	{
+		maximums.pop_front();
+	}
+
+	return val;
+}
+
+template<typename TValue, typename TCombine, typename TCompare>
+inline typename SlidingWindow<TValue, TCombine, TCompare>::const_reference SlidingWindow<TValue, TCombine, TCompare>::front() const
+{
+	if (values.empty()) throw std::runtime_error("window is empty");
+	return values.front();
+}
+
+template<typename TValue, typename TCombine, typename TCompare>
+inline typename SlidingWindow<TValue, TCombine, TCompare>::const_reference SlidingWindow<TValue, TCombine, TCompare>::back() const
+{
+	if (values.empty()) throw std::runtime_error("window is empty");
+	return values.back();
+}
+
+template<typename TValue, typename TCombine, typename TCompare>
+inline typename SlidingWindow<TValue, TCombine, TCompare>::const_reference SlidingWindow<TValue, TCombine, TCompare>::min() const
+{
+	if (values.empty()) throw std::runtime_error("window is empty");
+	return minimums.front();
+}
+
+template<typename TValue, typename TCombine, typename TCompare>
+inline typename SlidingWindow<TValue, TCombine, TCompare>::const_reference SlidingWindow<TValue, TCombine, TCompare>::max() const
+{
+	if (values.empty()) throw std::runtime_error("window is empty");
+	return maximums.front();
+}
+
+template<typename TValue, typename TCombine, typename TCompare>
+inline TValue SlidingWindow<TValue, TCombine, TCompare>::aggregate() const
+{
+	if (values.empty()) throw std::runtime_error("window is empty");
+
+	if (frontAggregates.empty())
+	{
+		return backAggregate;
+	}
+	if (backCount == 0)
+	{
+		return frontAggregates.front();
+	}
+	return combine(frontAggregates.front(), backAggregate);
+}
+
+template<typename TValue, typename TCombine, typename TCompare>
+inline TValue SlidingWindow<TValue, TCombine, TCompare>::sum() const
+{
+	return aggregate();
+}
+
+template<typename TValue, typename TCombine, typename TCompare>
+inline void SlidingWindow<TValue, TCombine, TCompare>::clear()
+{
+	values.clear();
+	minimums.clear();
+	maximums.clear();
+	frontAggregates.clear();
+	backAggregate = TValue();
+	backCount = 0;
+}
+
+template<typename TValue, typename TCombine, typename TCompare>
+inline std::string SlidingWindow<TValue, TCombine, TCompare>::toString() const
+{
+	return values.toString();
+}
+
+template<typename TValue, typename TCombine, typename TCompare>
+inline void SlidingWindow<TValue, TCombine, TCompare>::flip()
+{
+	// the front part is empty, so values holds exactly the back part; walk it newest to oldest
+	auto it = values.rbegin();
+	TValue suffix = *it;
+	frontAggregates.push_front(suffix);
+	for (--it; it != values.rend(); --it)
+	{
+		suffix = combine(*it, suffix);
+		frontAggregates.push_front(suffix);
+	}
+
+	backAggregate = TValue();
+	backCount = 0;
+}
@@ -0,0 +1,742 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "AggregateFields.h"
+
+/**
+
+	@class   SoaLinkedList
+	@brief   Doubly-linked list of aggregates stored as a structure of arrays
+
+	@details ~ Every node is an index. The links of all nodes live in one array and each field of TValue in it's own
+			   column, so a scan that reads one field only pulls that field's column into cache.
+			   column<I>() returns field I of every value as a contiguous span in list order, ready for vectorized loops;
+			   it first compacts the list if it is not in order already. push_back() and pop_back() keep a compact list
+			   compact, other insertions and removals leave holes or break the order until the next compact().
+			   Iterators dereference to a proxy reference, which converts to TValue, can be assigned a TValue,
+			   and gives direct access to single fields through get<I>().
+	@tparam  TValue - flat aggregate with 1 to 8 fields, see aggregateFieldCount(); bool fields are not supported,
+					  std::vector<bool> cannot hand out a span or a bool&, use std::uint8_t for flags
+
+**/
+template<typename TValue>
+class SoaLinkedList
+{
+	static_assert(std::is_aggregate_v<TValue>, "SoaLinkedList requires an aggregate value type");
+
+public:
+	static constexpr std::size_t FieldCount = aggregateFieldCount<TValue>();
+
+	using value_type = TValue;
+	using size_type = std::size_t;
+
+	template<std::size_t I>
+	using field_type = AggregateField<TValue, I>;
+
+	class reference;
+	class iterator;
+
+	/**
+		@brief Construct an empty list
+	**/
+	SoaLinkedList();
+
+	/**
+		@brief  Returns size of the list
+
+		Performs in O(1) constant time
+	**/
+	size_type size() const noexcept;
+
+	/**
+		@brief  Determines if the list is empty
+
+		Performs in O(1) constant time
+	**/
+	bool empty() const noexcept;
+
+	/**
+		@brief Reserve room for n nodes in the link array and every column
+	**/
+	void reserve(size_type n);
+
+	/**
+		@brief Add a value to the front of the list
+
+		Performs in O(1) amortized constant time
+		@param val - value to add
+	**/
+	void push_front(const TValue& val);
+
+	/**
+		@brief Add a value to the end of the list, keeps a compact list compact
+
+		Performs in O(1) amortized constant time
+		@param val - value to add
+	**/
+	void push_back(const TValue& val);
+
+	/**
+		@brief  Return the value at the beginning of the list
+		@exception std::runtime_error if list is empty
+	**/
+	reference front();
+	value_type front() const;
+
+	/**
+		@brief  Return the value at the end of the list
+		@exception std::runtime_error if list is empty
+	**/
+	reference back();
+	value_type back() const;
+
+	/**
+		@brief Removes the value at the beginning of the list and returns it
+
+		Performs in O(1) constant time
+		@exception std::runtime_error if list is empty
+	**/
+	value_type pop_front();
+
+	/**
+		@brief Removes the value at the end of the list and returns it, keeps a compact list compact
+
+		Performs in O(1) constant time
+		@exception std::runtime_error if list is empty
+	**/
+	value_type pop_back();
+
+	/**
+		@brief  Removes the value the iterator points at
+
+		Performs in O(1) constant time
+		@param  pos - valid, dereferenceable iterator into this list
+		@retval iterator pointing at the value following the removed one
+	**/
+	iterator erase(iterator pos);
+
+	/**
+		@brief Removes all values of the list
+	**/
+	void clear() noexcept;
+
+	/**
+		@brief Move every value to the slot matching it's position in the list, removing holes left by erased values
+
+		Performs in O(n) linear time, where n = the number of values in the list
+	**/
+	void compact();
+
+	/**
+		@brief  Determines if slot i holds the i-th value for every value, i.e. the columns can be scanned directly
+	**/
+	bool isCompact() const noexcept;
+
+	/**
+		@brief  Field I of every value, in list order
+
+		Compacts the list first if needed, so O(1) on a compact list and O(n) otherwise.
+		The span is invalidated by the next modification of the list.
+		@tparam I - index of the field
+		@retval std::span over the column
+	**/
+	template<std::size_t I>
+	std::span<field_type<I>> column();
+
+	iterator begin() noexcept;
+	iterator end() noexcept;
+
+	/**
+		@brief Get string representation of the list's values suitable for display
+	**/
+	std::string toString() const;
+
+private:
+	using Index = std::uint32_t;
+	static constexpr Index None = std::numeric_limits<Index>::max();
+
+	struct Link
+	{
+		Index next;
+		Index prev;
+	};
+
+	template<typename TIndices>
+	struct ColumnsOf;
+
+	template<std::size_t... I>
+	struct ColumnsOf<std::index_sequence<I...>>
+	{
+		// std::vector<bool> packs bits: it has no data() for column() and no bool& for get()
+		static_assert(!(std::is_same_v<std::remove_cv_t<field_type<I>>, bool> || ...), "SoaLinkedList does not support bool fields, use std::uint8_t instead");
+		using type = std::tuple<std::vector<field_type<I>>...>;
+	};
+
+	using Columns = typename ColumnsOf<std::make_index_sequence<FieldCount>>::type;
+
+	// links and fields of node i are at position i of links and every column
+	std::vector<Link> links;
+	Columns columns;
+
+	Index head;
+	Index tail;
+	// unused slots, linked through Link::next
+	Index freeList;
+	size_type count;
+
+	// slot i holds the i-th value and there are no unused slots
+	bool compacted;
+
+	// Take a slot for val, reusing an unused slot if there is one
+	Index allocate(const TValue& val);
+	// Give back node's slot, the slot at the end of the arrays is dropped instead of kept as unused
+	void release(Index node);
+
+	// Link a new node AFTER/BEFORE the given node (None = list is empty)
+	void linkAfter(Index node, Index newNode) noexcept;
+	void linkBefore(Index node, Index newNode) noexcept;
+	// Unlink node and return it's value
+	TValue unlink(Index node);
+
+	TValue load(Index node) const;
+	void store(Index node, const TValue& val);
+
+	template<std::size_t... I>
+	TValue load(Index node, std::index_sequence<I...>) const;
+	template<std::size_t... I>
+	void store(Index node, const TValue& val, std::index_sequence<I...>);
+	template<std::size_t... I>
+	void append(const TValue& val, std::index_sequence<I...>);
+	template<std::size_t... I>
+	void dropLast(std::index_sequence<I...>) noexcept;
+	template<std::size_t... I>
+	void permute(const std::vector<Index>& order, std::index_sequence<I...>);
+};
+
+/**
+	@class  SoaLinkedList::reference
+	@brief  Stands in for TValue& to a value stored across the columns
+**/
+template<typename TValue>
+class SoaLinkedList<TValue>::reference
+{
+public:
+	/**
+		@brief  Direct reference to field I of the value
+	**/
+	template<std::size_t I>
+	field_type<I>& get() const noexcept
+	{
+		return std::get<I>(list->columns)[node];
+	}
+
+	/**
+		@brief  Copy of the value, gathered from the columns
+	**/
+	operator TValue() const
+	{
+		return list->load(node);
+	}
+
+	/**
+		@brief Overwrite the value, scattering it's fields to the columns
+	**/
+	const reference& operator=(const TValue& val) const
+	{
+		list->store(node, val);
+		return *this;
+	}
+
+	// assigns the referenced value like TValue& would, does not rebind
+	const reference& operator=(const reference& other) const
+	{
+		return *this = static_cast<TValue>(other);
+	}
+
+private:
+	SoaLinkedList<TValue>* list;
+	Index node;
+
+	reference(SoaLinkedList<TValue>* list, Index node) noexcept
+		: list(list)
+		, node(node)
+	{}
+
+	friend class SoaLinkedList<TValue>;
+};
+
+/**
+	@class  SoaLinkedList::iterator
+	@brief  Bidirectional iterator over a SoaLinkedList, dereferences to SoaLinkedList::reference
+**/
+template<typename TValue>
+class SoaLinkedList<TValue>::iterator
+{
+public:
+	// a proxy reference does not meet the forward iterator requirements
+	using iterator_category = std::input_iterator_tag;
+	using value_type = TValue;
+	using difference_type = std::ptrdiff_t;
+	using pointer = void;
+	using reference = typename SoaLinkedList<TValue>::reference;
+
+	constexpr iterator() noexcept
+		: list(nullptr)
+		, current(None)
+	{}
+
+	reference operator*() const noexcept
+	{
+		return reference(list, current);
+	}
+
+	iterator& operator++() noexcept
+	{
+		current = list->links[current].next;
+		return *this;
+	}
+
+	iterator operator++(int) noexcept
+	{
+		auto it = *this;
+		++*this;
+		return it;
+	}
+
+	iterator& operator--() noexcept
+	{
+		current = current == None ? list->tail : list->links[current].prev;
+		return *this;
+	}
+
+	iterator operator--(int) noexcept
+	{
+		auto it = *this;
+		--*this;
+		return it;
+	}
+
+	bool operator==(const iterator& other) const noexcept
+	{
+		return current == other.current;
+	}
+
+	bool operator!=(const iterator& other) const noexcept
+	{
+		return !(*this == other);
+	}
+
+private:
+	SoaLinkedList<TValue>* list;
+	Index current;
+
+	iterator(SoaLinkedList<TValue>* list, Index current) noexcept
+		: list(list)
+		, current(current)
+	{}
+
+	friend class SoaLinkedList<TValue>;
+};
+
+template<typename TValue>
+inline SoaLinkedList<TValue>::SoaLinkedList()
+	: links()
+	, columns()
+	, head(None)
+	, tail(None)
+	, freeList(None)
+	, count(0)
+	, compacted(true)
+{}
+
+template<typename TValue>
+inline std::size_t SoaLinkedList<TValue>::size() const noexcept
+{
+	return count;
+}
+
+template<typename TValue>
+inline bool SoaLinkedList<TValue>::empty() const noexcept
+{
+	return count == 0;
+}
+
+template<typename TValue>
+inline void SoaLinkedList<TValue>::reserve(size_type n)
+{
+	links.reserve(n);
+	std::apply([n](auto&... column) { (column.reserve(n), ...); }, columns);
+}
+
+template<typename TValue>
+inline void SoaLinkedList<TValue>::push_front(const TValue& val)
+{
+	auto node = allocate(val);
+	if (count > 0)
+	{
+		// the new value sits in a slot after the old head
+		compacted = false;
+	}
+	linkBefore(head, node);
+}
+
+template<typename TValue>
+inline void SoaLinkedList<TValue>::push_back(const TValue& val)
+{
+	linkAfter(tail, allocate(val));
+}
+
+template<typename TValue>
+inline typename SoaLinkedList<TValue>::reference SoaLinkedList<TValue>::front()
+{
+	if (head == None) throw std::runtime_error("list is empty");
+	return reference(this, head);
+}
+
+template<typename TValue>
+inline TValue SoaLinkedList<TValue>::front() const
+{
+	if (head == None) throw std::runtime_error("list is empty");
+	return load(head);
+}
+
+template<typename TValue>
+inline typename SoaLinkedList<TValue>::reference SoaLinkedList<TValue>::back()
+{
+	if (tail == None) throw std::runtime_error("list is empty");
+	return reference(this, tail);
+}
+
+template<typename TValue>
+inline TValue SoaLinkedList<TValue>::back() const
+{
+	if (tail == None) throw std::runtime_error("list is empty");
+	return load(tail);
+}
+
+template<typename TValue>
+inline TValue SoaLinkedList<TValue>::pop_front()
+{
+	if (head == None) throw std::runtime_error("cannot remove from empty list");
+	if (count > 1)
+	{
+		// slot 0 becomes a hole
+		compacted = false;
+	}
+	return unlink(head);
+}
+
+template<typename TValue>
+inline TValue SoaLinkedList<TValue>::pop_back()
+{
+	if (tail == None) throw std::runtime_error("cannot remove from empty list");
+	return unlink(tail);
+}
+
+template<typename TValue>
+inline typename SoaLinkedList<TValue>::iterator SoaLinkedList<TValue>::erase(iterator pos)
+{
+	auto next = links[pos.current].next;
+	if (next != None)
+	{
+		compacted = false;
+	}
+	unlink(pos.current);
+	return iterator(this, next);
+}
+
+template<typename TValue>
+inline void SoaLinkedList<TValue>::clear() noexcept
+{
+	links.clear();
+	std::apply([](auto&... column) { (column.clear(), ...); }, columns);
+	head = None;
+	tail = None;
+	freeList = None;
+	count = 0;
+	compacted = true;
+}
+
+template<typename TValue>
+inline void SoaLinkedList<TValue>::compact()
+{
+	if (compacted)
+	{
+		return;
+	}
+
+	std::vector<Index> order;
+	order.reserve(count);
+	for (auto n = head; n != None; n = links[n].next)
+	{
+		order.push_back(n);
+	}
+
+	permute(order, std::make_index_sequence<FieldCount>());
+
+	links.resize(count);
+	for (Index i = 0; i < count; i++)
+	{
+		links[i].next = i + 1 < count ? i + 1 : None;
+		links[i].prev = i > 0 ? i - 1 : None;
+	}
+	head = count > 0 ? 0 : None;
+	tail = count > 0 ? static_cast<Index>(count - 1) : None;
+	freeList = None;
+	compacted = true;
+}
+
+template<typename TValue>
+inline bool SoaLinkedList<TValue>::isCompact() const noexcept
+{
+	return compacted;
+}
+
+template<typename TValue>
+template<std::size_t I>
+inline std::span<typename SoaLinkedList<TValue>::template field_type<I>> SoaLinkedList<TValue>::column()
+{
+	compact();
+	return std::span<field_type<I>>(std::get<I>(columns).data(), count);
+}
+
+template<typename TValue>
+inline typename SoaLinkedList<TValue>::iterator SoaLinkedList<TValue>::begin() noexcept
+{
+	return iterator(this, head);
+}
+
+template<typename TValue>
+inline typename SoaLinkedList<TValue>::iterator SoaLinkedList<TValue>::end() noexcept
+{
+	return iterator(this, None);
+}
+
+template<typename TValue>
+inline std::string SoaLinkedList<TValue>::toString() const
+{
+	std::stringstream ss;
+	for (auto n = head; n != None; n = links[n].next)
+	{
+		ss << '[';
+		std::apply([&](const auto&... column) {
+			const char* separator = "";
+			((ss << separator << column[n], separator = ", "), ...);
+		}, columns);
+		ss << ']';
+		if (links[n].next != None)
+		{
+			ss << "<->";
+		}
+	}
+	return ss.str();
+}
+
+template<typename TValue>
+inline typename SoaLinkedList<TValue>::Index SoaLinkedList<TValue>::allocate(const TValue& val)
+{
+	if (freeList != None)
+	{
+		auto node = freeList;
+		store(node, val);
+		freeList = links[node].next;
+		return node;
+	}
+
+	if (links.size() >= None) throw std::runtime_error("list is full");
+
+	append(val, std::make_index_sequence<FieldCount>());
+	try
+	{
+		links.push_back(Link{ None, None });
+	}
+	catch (...)
+	{
+		dropLast(std::make_index_sequence<FieldCount>());
+		throw;
+	}
+	return static_cast<Index>(links.size() - 1);
+}
+
+template<typename TValue>
+inline void SoaLinkedList<TValue>::release(Index node)
+{
+	if (node + 1 == links.size())
+	{
+		links.pop_back();
+		dropLast(std::make_index_sequence<FieldCount>());
+	}
+	else
+	{
+		links[node].next = freeList;
+		freeList = node;
+	}
+}
+
+template<typename TValue>
+inline void SoaLinkedList<TValue>::linkAfter(Index node, Index newNode) noexcept
+{
+	links[newNode].prev = node;
+	if (node != None)
+	{
+		links[newNode].next = links[node].next;
+		links[node].next = newNode;
+	}
+	else
+	{
+		// adding into empty list
+		links[newNode].next = None;
+		head = newNode;
+	}
+
+	if (links[newNode].next != None)
+	{
+		links[links[newNode].next].prev = newNode;
+	}
+	else
+	{
+		tail = newNode;
+	}
+	count++;
+}
+
+template<typename TValue>
+inline void SoaLinkedList<TValue>::linkBefore(Index node, Index newNode) noexcept
+{
+	links[newNode].next = node;
+	if (node != None)
+	{
+		links[newNode].prev = links[node].prev;
+		links[node].prev = newNode;
+	}
+	else
+	{
+		// adding into empty list
+		links[newNode].prev = None;
+		tail = newNode;
+	}
+
+	if (links[newNode].prev != None)
+	{
+		links[links[newNode].prev].next = newNode;
+	}
+	else
+	{
+		head = newNode;
+	}
+	count++;
+}
+
+template<typename TValue>
+inline TValue SoaLinkedList<TValue>::unlink(Index node)
+{
+	auto val = load(node);
+	auto [next, prev] = links[node];
+
+	if (next != None)
+	{
+		links[next].prev = prev;
+	}
+	else
+	{
+		tail = prev;
+	}
+
+	if (prev != None)
+	{
+		links[prev].next = next;
+	}
+	else
+	{
+		head = next;
+	}
+
+	count--;
+	release(node);
+	if (count == 0)
+	{
+		// drop unused slots, an empty list is compact
+		clear();
+	}
+	return val;
+}
+
+template<typename TValue>
+inline TValue SoaLinkedList<TValue>::load(Index node) const
+{
+	return load(node, std::make_index_sequence<FieldCount>());
+}
+
+template<typename TValue>
+inline void SoaLinkedList<TValue>::store(Index node, const TValue& val)
+{
+	store(node, val, std::make_index_sequence<FieldCount>());
+}
+
+template<typename TValue>
+template<std::size_t... I>
+inline TValue SoaLinkedList<TValue>::load(Index node, std::index_sequence<I...>) const
+{
+	return TValue{ std::get<I>(columns)[node]... };
+}
+
+template<typename TValue>
+template<std::size_t... I>
+inline void SoaLinkedList<TValue>::store(Index node, const TValue& val, std::index_sequence<I...>)
+{
+	auto fields = tieFields(val);
+	((std::get<I>(columns)[node] = std::get<I>(fields)), ...);
+}
+
+template<typename TValue>
+template<std::size_t... I>
+inline void SoaLinkedList<TValue>::append(const TValue& val, std::index_sequence<I...>)
+{
+	auto fields = tieFields(val);
+	std::size_t appended = 0;
+	try
+	{
+		((std::get<I>(columns).push_back(std::get<I>(fields)), appended++), ...);
+	}
+	catch (...)
+	{
+		// keep every column the same length as links
+		((I < appended ? std::get<I>(columns).pop_back() : void()), ...);
+		throw;
+	}
+}
+
+template<typename TValue>
+template<std::size_t... I>
+inline void SoaLinkedList<TValue>::dropLast(std::index_sequence<I...>) noexcept
+{
+	(std::get<I>(columns).pop_back(), ...);
+}
+
+template<typename TValue>
+template<std::size_t... I>
+inline void SoaLinkedList<TValue>::permute(const std::vector<Index>& order, std::index_sequence<I...>)
+{
+	// gather one column at a time, each pass streams the order array and one column
+	auto gather = [&order](auto& column) {
+		std::remove_reference_t<decltype(column)> ordered;
+		ordered.reserve(order.size());
+		for (auto n : order)
+		{
+			ordered.push_back(std::move(column[n]));
+		}
+		column = std::move(ordered);
+	};
+	(gather(std::get<I>(columns)), ...);
+}
@@ -0,0 +1,646 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "NodeCache.h"
+
+/**
+
+	@class   SortedLinkedList
+	@brief   Doubly-linked list kept in sorted order, with a sparse index of sampled nodes to find positions quickly
+
+	@details ~ Keeping a LinkedList sorted means walking from begin() to every insertion point, O(n) per insert.
+			   SortedLinkedList keeps a vector of every stride-th node together with a copy of it's value: a search binary-searches
+			   the samples for the last one ordered before the value and walks from there, O(log(n/k) + k) for a stride of k.
+			   Insertions and removals leave the index usable: a search that has to walk more than twice the stride makes the
+			   node stride steps into the walk a new sample, and erasing a sampled node hands it's place to the next node.
+			   merge() relinks the nodes of two lists in one linear pass and drops the index; it is rebuilt by the next
+			   search that needs it. Equal values keep the order they were inserted in, insert() adds after them.
+			   Nodes come from the NodeCache shared with LinkedList, so merge() can move nodes between lists.
+	@tparam  TValue   - type of list's values
+	@tparam  TCompare - strict weak ordering of the values, std::less by default
+
+**/
+template<typename TValue, typename TCompare = std::less<TValue>>
+class SortedLinkedList
+{
+public:
+	using value_type = TValue;
+	using reference = value_type&;
+	using const_reference = const value_type&;
+	using size_type = std::size_t;
+
+	class iterator;
+
+	/**
+		@brief Construct an empty list
+		@param stride  - distance between sampled nodes, at least 2; lookups walk about this many nodes
+		@param compare - ordering of the values
+	**/
+	explicit SortedLinkedList(size_type stride = 16, TCompare compare = TCompare());
+	~SortedLinkedList();
+
+	SortedLinkedList(const SortedLinkedList&) = delete;
+	SortedLinkedList& operator=(const SortedLinkedList&) = delete;
+
+	/**
+		@brief  Returns size of the list
+
+		Performs in O(1) constant time
+	**/
+	size_type size() const noexcept;
+
+	/**
+		@brief  Determines if the list is empty
+
+		Performs in O(1) constant time
+	**/
+	bool empty() const noexcept;
+
+	/**
+		@brief  Return the smallest value
+		@exception std::runtime_error if list is empty
+	**/
+	const_reference front() const;
+
+	/**
+		@brief  Return the largest value
+		@exception std::runtime_error if list is empty
+	**/
+	const_reference back() const;
+
+	/**
+		@brief  Removes the smallest value and returns it
+
+		Performs in O(1) constant time, O(n/k) when it is a sampled node
+		@exception std::runtime_error if list is empty
+	**/
+	value_type pop_front();
+
+	/**
+		@brief  Removes the largest value and returns it
+
+		Performs in O(1) constant time, O(n/k) when it is a sampled node
+		@exception std::runtime_error if list is empty
+	**/
+	value_type pop_back();
+
+	/**
+		@brief  Add a value at it's place in the order, after any equal values
+
+		Performs in O(log(n/k) + k) time, where k = the stride
+		@param  val - value to add
+		@retval iterator pointing at the added value
+	**/
+	iterator insert(const TValue& val);
+
+	/**
+		@brief  Search the list for the first value equivalent to val
+
+		Performs in O(log(n/k) + k) time, where k = the stride
+		@param  val - value to search for
+		@retval iterator pointing at the found value, or end() if there is none
+	**/
+	iterator find(const TValue& val);
+
+	/**
+		@brief  Determines if the list contains a value equivalent to val
+	**/
+	bool contains(const TValue& val);
+
+	/**
+		@brief  First value not ordered before val
+
+		Performs in O(log(n/k) + k) time, where k = the stride
+		@retval iterator pointing at the value, or end() if all values are ordered before val
+	**/
+	iterator lower_bound(const TValue& val);
+
+	/**
+		@brief  First value ordered after val
+
+		Performs in O(log(n/k) + k) time, where k = the stride
+		@retval iterator pointing at the value, or end() if no value is ordered after val
+	**/
+	iterator upper_bound(const TValue& val);
+
+	/**
+		@brief  Removes the value the iterator points at
+
+		Performs in O(1) constant time, O(n/k) when it is a sampled node
+		@param  pos - valid, dereferenceable iterator into this list
+		@retval iterator pointing at the value following the removed one
+	**/
+	iterator erase(iterator pos);
+
+	/**
+		@brief Move all values of another list into this one, keeping the order; the other list is left empty
+
+		Equal values from this list come before those from the other. No value is copied or moved.
+		Performs in O(n + m) linear time, where n and m = the number of values in both lists
+		@param other - list to take the values from
+	**/
+	void merge(SortedLinkedList& other);
+
+	/**
+		@brief Removes all values of the list
+	**/
+	void clear() noexcept;
+
+	iterator begin() noexcept;
+	iterator end() noexcept;
+
+	/**
+		@brief Get string representation of the list's values suitable for display
+	**/
+	std::string toString() const;
+
+private:
+	struct Node
+	{
+		Node* next;
+		Node* prev;
+		// the node is in samples
+		bool sampled;
+		TValue value;
+
+		explicit Node(const TValue& val)
+			: next(nullptr)
+			, prev(nullptr)
+			, sampled(false)
+			, value(val)
+		{}
+	};
+
+	Node* head;
+	Node* tail;
+	size_type count;
+
+	const size_type stride;
+	TCompare compare;
+
+	// a sampled node with a copy of it's value, so the binary search does not touch the nodes
+	struct Sample
+	{
+		TValue value;
+		Node* node;
+	};
+
+	// every stride-th node in list order, more where searches found long runs
+	std::vector<Sample> samples;
+	// samples are out of date and rebuilt before the next search
+	bool indexStale;
+
+	// Sample every stride-th node, dropping the previous samples
+	void rebuildIndex();
+
+	// First node for which before(node) is false, walking from the last sample for which it is true
+	template<typename TBefore>
+	Node* search(const TValue& val, TBefore before);
+
+	// Hand a node's sample to the next node or drop it, needs the node's value intact
+	void unsample(Node* node) noexcept;
+	// Unlink a node and free it, a node whose value was moved out must be unsampled first
+	void removeNode(Node* node) noexcept;
+	static void destroy(Node* node) noexcept;
+};
+
+/**
+	@class  SortedLinkedList::iterator
+	@brief  Bidirectional iterator over a SortedLinkedList, values are read-only to keep the order intact
+**/
+template<typename TValue, typename TCompare>
+class SortedLinkedList<TValue, TCompare>::iterator
+{
+public:
+	using iterator_category = std::bidirectional_iterator_tag;
+	using value_type = TValue;
+	using difference_type = std::ptrdiff_t;
+	using pointer = const value_type*;
+	using reference = const value_type&;
+
+	constexpr iterator() noexcept
+		: list(nullptr)
+		, current(nullptr)
+	{}
+
+	reference operator*() const noexcept
+	{
+		return current->value;
+	}
+
+	pointer operator->() const noexcept
+	{
+		return &current->value;
+	}
+
+	iterator& operator++() noexcept
+	{
+		current = current->next;
+		return *this;
+	}
+
+	iterator operator++(int) noexcept
+	{
+		auto it = *this;
+		++*this;
+		return it;
+	}
+
+	iterator& operator--() noexcept
+	{
+		current = current == nullptr ? list->tail : current->prev;
+		return *this;
+	}
+
+	iterator operator--(int) noexcept
+	{
+		auto it = *this;
+		--*this;
+		return it;
+	}
+
+	bool operator==(const iterator& other) const noexcept
+	{
+		return current == other.current;
+	}
+
+	bool operator!=(const iterator& other) const noexcept
+	{
+		return current != other.current;
+	}
+
+private:
+	SortedLinkedList* list;
+	Node* current;
+
+	constexpr iterator(SortedLinkedList* list, Node* current) noexcept
+		: list(list)
+		, current(current)
+	{}
+
+	friend class SortedLinkedList<TValue, TCompare>;
+};
+
+template<typename TValue, typename TCompare>
+inline SortedLinkedList<TValue, TCompare>::SortedLinkedList(size_type stride, TCompare compare)
+	: head(nullptr)
+	, tail(nullptr)
+	, count(0)
+	, stride(stride < 2 ? 2 : stride)
+	, compare(std::move(compare))
+	, samples()
+	, indexStale(false)
+{}
+
+template<typename TValue, typename TCompare>
+inline SortedLinkedList<TValue, TCompare>::~SortedLinkedList()
+{
+	clear();
+}
+
+template<typename TValue, typename TCompare>
+inline std::size_t SortedLinkedList<TValue, TCompare>::size() const noexcept
+{
+	return count;
+}
+
+template<typename TValue, typename TCompare>
+inline bool SortedLinkedList<TValue, TCompare>::empty() const noexcept
+{
+	return head == nullptr;
+}
+
+template<typename TValue, typename TCompare>
+inline const TValue& SortedLinkedList<TValue, TCompare>::front() const
+{
+	if (head == nullptr) throw std::runtime_error("list is empty");
+	return head->value;
+}
+
+template<typename TValue, typename TCompare>
+inline const TValue& SortedLinkedList<TValue, TCompare>::back() const
+{
+	if (tail == nullptr) throw std::runtime_error("list is empty");
+	return tail->value;
+}
+
+template<typename TValue, typename TCompare>
+inline TValue SortedLinkedList<TValue, TCompare>::pop_front()
+{
+	if (head == nullptr) throw std::runtime_error("cannot remove from empty list");
+	// the sample is looked up by value, drop it before the value is moved out
+	auto node = head;
+	unsample(node);
+	auto val = std::move(node->value);
+	removeNode(node);
+	return val;
+}
+
+template<typename TValue, typename TCompare>
+inline TValue SortedLinkedList<TValue, TCompare>::pop_back()
+{
+	if (tail == nullptr) throw std::runtime_error("cannot remove from empty list");
+	auto node = tail;
+	unsample(node);
+	auto val = std::move(node->value);
+	removeNode(node);
+	return val;
+}
+
+template<typename TValue, typename TCompare>
+inline typename SortedLinkedList<TValue, TCompare>::iterator SortedLinkedList<TValue, TCompare>::insert(const TValue& val)
+{
+	auto memory = NodeCache<Node>::allocate();
+	Node* node;
+	try
+	{
+		node = ::new (memory) Node(val);
+	}
+	catch (...)
+	{
+		NodeCache<Node>::deallocate(memory);
+		throw;
+	}
+
+	Node* next;
+	try
+	{
+		next = search(val, [this](const TValue& a, const TValue& b) { return !compare(b, a); });
+	}
+	catch (...)
+	{
+		destroy(node);
+		throw;
+	}
+
+	node->next = next;
+	node->prev = next == nullptr ? tail : next->prev;
+	if (node->prev != nullptr)
+	{
+		node->prev->next = node;
+	}
+	else
+	{
+		head = node;
+	}
+	if (next != nullptr)
+	{
+		next->prev = node;
+	}
+	else
+	{
+		tail = node;
+	}
+	count++;
+	return iterator(this, node);
+}
+
+template<typename TValue, typename TCompare>
+inline typename SortedLinkedList<TValue, TCompare>::iterator SortedLinkedList<TValue, TCompare>::find(const TValue& val)
+{
+	auto node = lower_bound(val).current;
+	return node != nullptr && !compare(val, node->value) ? iterator(this, node) : end();
+}
+
+template<typename TValue, typename TCompare>
+inline bool SortedLinkedList<TValue, TCompare>::contains(const TValue& val)
+{
+	return find(val) != end();
+}
+
+template<typename TValue, typename TCompare>
+inline typename SortedLinkedList<TValue, TCompare>::iterator SortedLinkedList<TValue, TCompare>::lower_bound(const TValue& val)
+{
+	return iterator(this, search(val, [this](const TValue& a, const TValue& b) { return compare(a, b); }));
+}
+
+template<typename TValue, typename TCompare>
+inline typename SortedLinkedList<TValue, TCompare>::iterator SortedLinkedList<TValue, TCompare>::upper_bound(const TValue& val)
+{
+	return iterator(this, search(val, [this](const TValue& a, const TValue& b) { return !compare(b, a); }));
+}
+
+template<typename TValue, typename TCompare>
+inline typename SortedLinkedList<TValue, TCompare>::iterator SortedLinkedList<TValue, TCompare>::erase(iterator pos)
+{
+	auto next = pos.current->next;
+	removeNode(pos.current);
+	return iterator(this, next);
+}
+
+template<typename TValue, typename TCompare>
+inline void SortedLinkedList<TValue, TCompare>::merge(SortedLinkedList& other)
+{
+	if (this == &other || other.head == nullptr)
+	{
+		return;
+	}
+
+	// relink both chains into one through next, fixing prev afterwards
+	Node* merged = nullptr;
+	Node** link = &merged;
+	auto a = head;
+	auto b = other.head;
+	while (a != nullptr && b != nullptr)
+	{
+		// take from the other list only when strictly smaller, so equal values of this list stay first
+		auto& from = compare(b->value, a->value) ? b : a;
+		*link = from;
+		link = &from->next;
+		from = from->next;
+	}
+	*link = a != nullptr ? a : b;
+
+	head = merged;
+	Node* prev = nullptr;
+	for (auto n = head; n != nullptr; n = n->next)
+	{
+		n->prev = prev;
+		prev = n;
+	}
+	tail = prev;
+	count += other.count;
+	indexStale = true;
+
+	other.head = nullptr;
+	other.tail = nullptr;
+	other.count = 0;
+	other.samples.clear();
+	other.indexStale = false;
+}
+
+template<typename TValue, typename TCompare>
+inline void SortedLinkedList<TValue, TCompare>::clear() noexcept
+{
+	auto n = head;
+	while (n != nullptr)
+	{
+		auto next = n->next;
+		destroy(n);
+		n = next;
+	}
+	head = nullptr;
+	tail = nullptr;
+	count = 0;
+	samples.clear();
+	indexStale = false;
+}
+
+template<typename TValue, typename TCompare>
+inline typename SortedLinkedList<TValue, TCompare>::iterator SortedLinkedList<TValue, TCompare>::begin() noexcept
+{
+	return iterator(this, head);
+}
+
+template<typename TValue, typename TCompare>
+inline typename SortedLinkedList<TValue, TCompare>::iterator SortedLinkedList<TValue, TCompare>::end() noexcept
+{
+	return iterator(this, nullptr);
+}
+
+template<typename TValue, typename TCompare>
+inline std::string SortedLinkedList<TValue, TCompare>::toString() const
+{
+	std::stringstream ss;
+	for (auto n = head; n != nullptr; n = n->next)
+	{
+		ss << '[' << n->value << ']';
+		if (n->next != nullptr)
+		{
+			ss << "<->";
+		}
+	}
+	return ss.str();
+}
+
+template<typename TValue, typename TCompare>
+inline void SortedLinkedList<TValue, TCompare>::rebuildIndex()
+{
+	// stays set if copying a value throws, the sampled flags are reset by the next attempt
+	indexStale = true;
+	samples.clear();
+	samples.reserve(count / stride + 1);
+	size_type i = 0;
+	for (auto n = head; n != nullptr; n = n->next, i++)
+	{
+		n->sampled = i % stride == 0;
+		if (n->sampled)
+		{
+			samples.push_back(Sample{ n->value, n });
+		}
+	}
+	indexStale = false;
+}
+
+template<typename TValue, typename TCompare>
+template<typename TBefore>
+inline SortedLinkedList<TValue, TCompare>::Node* SortedLinkedList<TValue, TCompare>::search(const TValue& val, TBefore before)
+{
+	// rebuilt when out of date or when the list outgrew it, both at most once per O(n) changes
+	if (indexStale || count > 2 * stride * (samples.size() + 1))
+	{
+		rebuildIndex();
+	}
+
+	// samples for which before() holds come first, start at the last of them
+	auto it = std::partition_point(samples.begin(), samples.end(), [&](const Sample& sample) { return before(sample.value, val); });
+	auto n = it == samples.begin() ? head : (it - 1)->node;
+
+	size_type steps = 0;
+	Node* middle = nullptr;
+	while (n != nullptr && before(n->value, val))
+	{
+		n = n->next;
+		if (++steps == stride)
+		{
+			middle = n;
+		}
+	}
+
+	// a long run between two samples: split it, so the next search in it walks half as far
+	if (steps > 2 * stride && middle != nullptr && !middle->sampled)
+	{
+		samples.insert(it, Sample{ middle->value, middle });
+		middle->sampled = true;
+	}
+	return n;
+}
+
+template<typename TValue, typename TCompare>
+inline void SortedLinkedList<TValue, TCompare>::unsample(Node* node) noexcept
+{
+	if (node->sampled && !indexStale)
+	{
+		auto it = std::partition_point(samples.begin(), samples.end(), [&](const Sample& sample) { return compare(sample.value, node->value); });
+		while (it != samples.end() && it->node != node)
+		{
+			++it;
+		}
+		if (it == samples.end())
+		{
+			// not where the order says it should be, let the next search rebuild the index
+			indexStale = true;
+			return;
+		}
+		auto next = node->next;
+		// the next node takes over the sample unless it is a sample itself
+		if (next != nullptr && !next->sampled)
+		{
+			try
+			{
+				it->value = next->value;
+				it->node = next;
+				next->sampled = true;
+			}
+			catch (...)
+			{
+				indexStale = true;
+			}
+		}
+		else
+		{
+			samples.erase(it);
+		}
+	}
+	node->sampled = false;
+}
+
+template<typename TValue, typename TCompare>
+inline void SortedLinkedList<TValue, TCompare>::removeNode(Node* node) noexcept
+{
+	unsample(node);
+
+	if (node->prev != nullptr)
+	{
+		node->prev->next = node->next;
+	}
+	else
+	{
+		head = node->next;
+	}
+	if (node->next != nullptr)
+	{
+		node->next->prev = node->prev;
+	}
+	else
+	{
+		tail = node->prev;
+	}
+	count--;
+	destroy(node);
+}
+
+template<typename TValue, typename TCompare>
+inline void SortedLinkedList<TValue, TCompare>::destroy(Node* node) noexcept
+{
+	node->~Node();
+	NodeCache<Node>::deallocate(node);
+}
@@ -0,0 +1,685 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+/**
+
+	@class   StaticLinkedList
+	@brief   Doubly-linked list with a fixed capacity and all node storage inside the object
+
+	@details ~ Never allocates: the N nodes are an array member, linked by index, and removed nodes go onto an index-linked
+			   free list. Indices use the smallest unsigned type that can address N nodes, so links of small lists take
+			   two bytes per node. Construction does not touch the node array, nodes are handed out from a bump index
+			   until the free list has entries. Every operation is O(1) without allocation or amortization.
+			   push_front()/push_back() report a full list by returning false instead of throwing, and
+			   try_pop_front()/try_pop_back() do the same for an empty list.
+	@tparam  TValue - type of list's values
+	@tparam  N      - maximum number of values
+
+**/
+template<typename TValue, std::size_t N>
+class StaticLinkedList
+{
+	static_assert(N > 0, "StaticLinkedList needs a capacity of at least one value");
+	static_assert(N < std::numeric_limits<std::uint32_t>::max(), "StaticLinkedList capacity must fit 32-bit indices");
+
+public:
+	using value_type = TValue;
+	using reference = value_type&;
+	using const_reference = const value_type&;
+	using size_type = std::size_t;
+
+	class iterator;
+
+	/**
+		@brief Construct an empty list
+
+		Performs in O(1) constant time, the node array is left untouched
+	**/
+	constexpr StaticLinkedList() noexcept;
+	~StaticLinkedList();
+
+	/**
+		@brief Construct a list holding copies of another list's values
+	**/
+	StaticLinkedList(const StaticLinkedList& other);
+	StaticLinkedList& operator=(const StaticLinkedList& other);
+
+	/**
+		@brief  Returns size of the list
+
+		Performs in O(1) constant time
+	**/
+	size_type size() const noexcept;
+
+	/**
+		@brief  Maximum number of values the list can hold, N
+	**/
+	static constexpr size_type capacity() noexcept;
+
+	/**
+		@brief  Determines if the list is empty
+
+		Performs in O(1) constant time
+	**/
+	bool empty() const noexcept;
+
+	/**
+		@brief  Determines if the list holds capacity() values, i.e. the next push will fail
+
+		Performs in O(1) constant time
+	**/
+	bool full() const noexcept;
+
+	/**
+		@brief  Add an element to the front of the list
+
+		Performs in O(1) constant time
+		@param  val - value to add
+		@retval bool true if the value was added, false if the list is full
+	**/
+	[[nodiscard]] bool push_front(const TValue& val);
+	[[nodiscard]] bool push_front(TValue&& val);
+
+	/**
+		@brief  Add an element to the end of the list
+
+		Performs in O(1) constant time
+		@param  val - value to add
+		@retval bool true if the value was added, false if the list is full
+	**/
+	[[nodiscard]] bool push_back(const TValue& val);
+	[[nodiscard]] bool push_back(TValue&& val);
+
+	/**
+		@brief  Return the value at the beginning of the list
+		@exception std::runtime_error if list is empty
+	**/
+	reference front();
+	const_reference front() const;
+
+	/**
+		@brief  Return the value at the end of the list
+		@exception std::runtime_error if list is empty
+	**/
+	reference back();
+	const_reference back() const;
+
+	/**
+		@brief  Removes the value at the beginning of the list and returns it
+
+		Performs in O(1) constant time
+		@exception std::runtime_error if list is empty
+	**/
+	value_type pop_front();
+
+	/**
+		@brief  Removes the value at the end of the list and returns it
+
+		Performs in O(1) constant time
+		@exception std::runtime_error if list is empty
+	**/
+	value_type pop_back();
+
+	/**
+		@brief  Removes the value at the beginning of the list, if there is one
+
+		Performs in O(1) constant time
+		@param  out - receives the removed value
+		@retval bool true if a value was removed, false if the list is empty
+	**/
+	bool try_pop_front(TValue& out);
+
+	/**
+		@brief  Removes the value at the end of the list, if there is one
+
+		Performs in O(1) constant time
+		@param  out - receives the removed value
+		@retval bool true if a value was removed, false if the list is empty
+	**/
+	bool try_pop_back(TValue& out);
+
+	/**
+		@brief  Removes the value the iterator points at
+
+		Performs in O(1) constant time
+		@param  pos - valid, dereferenceable iterator into this list
+		@retval iterator pointing at the value following the removed one
+	**/
+	iterator erase(iterator pos);
+
+	/**
+		@brief  Search the list for the first node holding a value
+
+		Performs in O(n) linear time, where n = the number of values in the list
+		@retval iterator pointing at the found value, or end() if the value is not in the list
+	**/
+	iterator find(const TValue& val);
+
+	/**
+		@brief  Determines if the list contains a value
+
+		Performs in O(n) linear time, where n = the number of values in the list
+	**/
+	bool contains(const TValue& val) const;
+
+	/**
+		@brief Removes all values of the list
+
+		Performs in O(n) linear time for values with destructors, O(1) constant time otherwise
+	**/
+	void clear() noexcept;
+
+	iterator begin() noexcept;
+	iterator end() noexcept;
+
+	/**
+		@brief Get string representation of the list's values suitable for display
+	**/
+	std::string toString() const;
+
+private:
+	// smallest index type able to address N nodes plus the None marker
+	using Index = std::conditional_t<(N < 0xFF), std::uint8_t,
+		std::conditional_t<(N < 0xFFFF), std::uint16_t, std::uint32_t>>;
+	static constexpr Index None = std::numeric_limits<Index>::max();
+
+	struct Node
+	{
+		Index next;
+		Index prev;
+		alignas(TValue) unsigned char storage[sizeof(TValue)];
+
+		TValue& value() noexcept
+		{
+			return *std::launder(reinterpret_cast<TValue*>(storage));
+		}
+
+		const TValue& value() const noexcept
+		{
+			return *std::launder(reinterpret_cast<const TValue*>(storage));
+		}
+	};
+
+	Node nodes[N];
+
+	Index head;
+	Index tail;
+	// removed nodes, linked through Node::next
+	Index freeList;
+	// nodes [0, used) were handed out at least once
+	Index used;
+	Index count;
+
+	// Take a free node and construct val in it, None if the list is full
+	template<typename TArg>
+	Index allocate(TArg&& val);
+	// Destroy a node's value and put the node on the free list
+	void release(Index node) noexcept;
+
+	// Link a new node AFTER/BEFORE the given node (None = list is empty)
+	void linkAfter(Index node, Index newNode) noexcept;
+	void linkBefore(Index node, Index newNode) noexcept;
+	// Unlink node, move it's value out and release the node
+	TValue unlink(Index node);
+};
+
+/**
+	@class  StaticLinkedList::iterator
+	@brief  Bidirectional iterator over a StaticLinkedList
+**/
+template<typename TValue, std::size_t N>
+class StaticLinkedList<TValue, N>::iterator
+{
+public:
+	using iterator_category = std::bidirectional_iterator_tag;
+	using value_type = TValue;
+	using difference_type = std::ptrdiff_t;
+	using pointer = value_type*;
+	using reference = value_type&;
+
+	constexpr iterator() noexcept
+		: list(nullptr)
+		, current(None)
+	{}
+
+	reference operator*() const noexcept
+	{
+		return list->nodes[current].value();
+	}
+
+	pointer operator->() const noexcept
+	{
+		return &list->nodes[current].value();
+	}
+
+	iterator& operator++() noexcept
+	{
+		current = list->nodes[current].next;
+		return *this;
+	}
+
+	iterator operator++(int) noexcept
+	{
+		auto it = *this;
+		++*this;
+		return it;
+	}
+
+	iterator& operator--() noexcept
+	{
+		current = current == None ? list->tail : list->nodes[current].prev;
+		return *this;
+	}
+
+	iterator operator--(int) noexcept
+	{
+		auto it = *this;
+		--*this;
+		return it;
+	}
+
+	bool operator==(const iterator& other) const noexcept
+	{
+		return current == other.current;
+	}
+
+	bool operator!=(const iterator& other) const noexcept
+	{
+		return !(*this == other);
+	}
+
+private:
+	StaticLinkedList<TValue, N>* list;
+	Index current;
+
+	constexpr iterator(StaticLinkedList<TValue, N>* list, Index current) noexcept
+		: list(list)
+		, current(current)
+	{}
+
+	friend class StaticLinkedList<TValue, N>;
+};
+
+template<typename TValue, std::size_t N>
+inline constexpr StaticLinkedList<TValue, N>::StaticLinkedList() noexcept
+	: head(None)
+	, tail(None)
+	, freeList(None)
+	, used(0)
+	, count(0)
+{}
+
+template<typename TValue, std::size_t N>
+inline StaticLinkedList<TValue, N>::~StaticLinkedList()
+{
+	clear();
+}
+
+template<typename TValue, std::size_t N>
+inline StaticLinkedList<TValue, N>::StaticLinkedList(const StaticLinkedList& other)
+	: StaticLinkedList()
+{
+	for (auto n = other.head; n != None; n = other.nodes[n].next)
+	{
+		linkAfter(tail, allocate(other.nodes[n].value()));
+	}
+}
+
+template<typename TValue, std::size_t N>
+inline StaticLinkedList<TValue, N>& StaticLinkedList<TValue, N>::operator=(const StaticLinkedList& other)
+{
+	if (this != &other)
+	{
+		clear();
+		for (auto n = other.head; n != None; n = other.nodes[n].next)
+		{
+			linkAfter(tail, allocate(other.nodes[n].value()));
+		}
+	}
+	return *this;
+}
+
+template<typename TValue, std::size_t N>
+inline std::size_t StaticLinkedList<TValue, N>::size() const noexcept
+{
+	return count;
+}
+
+template<typename TValue, std::size_t N>
+inline constexpr std::size_t StaticLinkedList<TValue, N>::capacity() noexcept
+{
+	return N;
+}
+
+template<typename TValue, std::size_t N>
+inline bool StaticLinkedList<TValue, N>::empty() const noexcept
+{
+	return count == 0;
+}
+
+template<typename TValue, std::size_t N>
+inline bool StaticLinkedList<TValue, N>::full() const noexcept
+{
+	return count == N;
+}
+
+template<typename TValue, std::size_t N>
+inline bool StaticLinkedList<TValue, N>::push_front(const TValue& val)
+{
+	auto node = allocate(val);
+	if (node == None)
+	{
+		return false;
+	}
+	linkBefore(head, node);
+	return true;
+}
+
+template<typename TValue, std::size_t N>
+inline bool StaticLinkedList<TValue, N>::push_front(TValue&& val)
+{
+	auto node = allocate(std::move(val));
+	if (node == None)
+	{
+		return false;
+	}
+	linkBefore(head, node);
+	return true;
+}
+
+template<typename TValue, std::size_t N>
+inline bool StaticLinkedList<TValue, N>::push_back(const TValue& val)
+{
+	auto node = allocate(val);
+	if (node == None)
+	{
+		return false;
+	}
+	linkAfter(tail, node);
+	return true;
+}
+
+template<typename TValue, std::size_t N>
+inline bool StaticLinkedList<TValue, N>::push_back(TValue&& val)
+{
+	auto node = allocate(std::move(val));
+	if (node == None)
+	{
+		return false;
+	}
+	linkAfter(tail, node);
+	return true;
+}
+
+template<typename TValue, std::size_t N>
+inline TValue& StaticLinkedList<TValue, N>::front()
+{
+	if (head == None) throw std::runtime_error("list is empty");
+	return nodes[head].value();
+}
+
+template<typename TValue, std::size_t N>
+inline const TValue& StaticLinkedList<TValue, N>::front() const
+{
+	if (head == None) throw std::runtime_error("list is empty");
+	return nodes[head].value();
+}
+
+template<typename TValue, std::size_t N>
+inline TValue& StaticLinkedList<TValue, N>::back()
+{
+	if (tail == None) throw std::runtime_error("list is empty");
+	return nodes[tail].value();
+}
+
+template<typename TValue, std::size_t N>
+inline const TValue& StaticLinkedList<TValue, N>::back() const
+{
+	if (tail == None) throw std::runtime_error("list is empty");
+	return nodes[tail].value();
+}
+
+template<typename TValue, std::size_t N>
+inline TValue StaticLinkedList<TValue, N>::pop_front()
+{
+	if (head == None) throw std::runtime_error("cannot remove from empty list");
+	return unlink(head);
+}
+
+template<typename TValue, std::size_t N>
+inline TValue StaticLinkedList<TValue, N>::pop_back()
+{
+	if (tail == None) throw std::runtime_error("cannot remove from empty list");
+	return unlink(tail);
+}
+
+template<typename TValue, std::size_t N>
+inline bool StaticLinkedList<TValue, N>::try_pop_front(TValue& out)
+{
+	if (head == None)
+	{
+		return false;
+	}
+	out = unlink(head);
+	return true;
+}
+
+template<typename TValue, std::size_t N>
+inline bool StaticLinkedList<TValue, N>::try_pop_back(TValue& out)
+{
+	if (tail == None)
+	{
+		return false;
+	}
+	out = unlink(tail);
+	return true;
+}
+
+template<typename TValue, std::size_t N>
+inline typename StaticLinkedList<TValue, N>::iterator StaticLinkedList<TValue, N>::erase(iterator pos)
+{
+	auto next = nodes[pos.current].next;
+	unlink(pos.current);
+	return iterator(this, next);
+}
+
+template<typename TValue, std::size_t N>
+inline typename StaticLinkedList<TValue, N>::iterator StaticLinkedList<TValue, N>::find(const TValue& val)
+{
+	auto n = head;
+	while (n != None && !(nodes[n].value() == val))
+	{
+		n = nodes[n].next;
+	}
+	return iterator(this, n);
+}
+
+template<typename TValue, std::size_t N>
+inline bool StaticLinkedList<TValue, N>::contains(const TValue& val) const
+{
+	for (auto n = head; n != None; n = nodes[n].next)
+	{
+		if (nodes[n].value() == val)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+template<typename TValue, std::size_t N>
+inline void StaticLinkedList<TValue, N>::clear() noexcept
+{
+	if constexpr (!std::is_trivially_destructible_v<TValue>)
+	{
+		for (auto n = head; n != None; n = nodes[n].next)
+		{
+			nodes[n].value().~TValue();
+		}
+	}
+	head = None;
+	tail = None;
+	freeList = None;
+	used = 0;
+	count = 0;
+}
+
+template<typename TValue, std::size_t N>
+inline typename StaticLinkedList<TValue, N>::iterator StaticLinkedList<TValue, N>::begin() noexcept
+{
+	return iterator(this, head);
+}
+
+template<typename TValue, std::size_t N>
+inline typename StaticLinkedList<TValue, N>::iterator StaticLinkedList<TValue, N>::end() noexcept
+{
+	return iterator(this, None);
+}
+
+template<typename TValue, std::size_t N>
+inline std::string StaticLinkedList<TValue, N>::toString() const
+{
+	std::stringstream ss;
+	for (auto n = head; n != None; n = nodes[n].next)
+	{
+		ss << '[' << nodes[n].value() << ']';
+		if (nodes[n].next != None)
+		{
+			ss << "<->";
+		}
+	}
+	return ss.str();
+}
+
+template<typename TValue, std::size_t N>
+template<typename TArg>
+inline typename StaticLinkedList<TValue, N>::Index StaticLinkedList<TValue, N>::allocate(TArg&& val)
+{
+	Index node;
+	if (freeList != None)
+	{
+		node = freeList;
+	}
+	else if (used < N)
+	{
+		node = used;
+	}
+	else
+	{
+		return None;
+	}
+
+	// construct first, the node stays free if the copy throws
+	::new (nodes[node].storage) TValue(std::forward<TArg>(val));
+	if (node == freeList)
+	{
+		freeList = nodes[node].next;
+	}
+	else
+	{
+		used++;
+	}
+	return node;
+}
+
+template<typename TValue, std::size_t N>
+inline void StaticLinkedList<TValue, N>::release(Index node) noexcept
+{
+	nodes[node].value().~TValue();
+	nodes[node].next = freeList;
+	freeList = node;
+}
+
+template<typename TValue, std::size_t N>
+inline void StaticLinkedList<TValue, N>::linkAfter(Index node, Index newNode) noexcept
+{
+	nodes[newNode].prev = node;
+	if (node != None)
+	{
+		nodes[newNode].next = nodes[node].next;
+		nodes[node].next = newNode;
+	}
+	else
+	{
+		// adding into empty list
+		nodes[newNode].next = None;
+		head = newNode;
+	}
+
+	if (nodes[newNode].next != None)
+	{
+		nodes[nodes[newNode].next].prev = newNode;
+	}
+	else
+	{
+		tail = newNode;
+	}
+	count++;
+}
+
+template<typename TValue, std::size_t N>
+inline void StaticLinkedList<TValue, N>::linkBefore(Index node, Index newNode) noexcept
+{
+	nodes[newNode].next = node;
+	if (node != None)
+	{
+		nodes[newNode].prev = nodes[node].prev;
+		nodes[node].prev = newNode;
+	}
+	else
+	{
+		// adding into empty list
+		nodes[newNode].prev = None;
+		tail = newNode;
+	}
+
+	if (nodes[newNode].prev != None)
+	{
+		nodes[nodes[newNode].prev].next = newNode;
+	}
+	else
+	{
+		head = newNode;
+	}
+	count++;
+}
+
+template<typename TValue, std::size_t N>
+inline TValue StaticLinkedList<TValue, N>::unlink(Index node)
+{
+	auto val = std::move(nodes[node].value());
+	auto next = nodes[node].next;
+	auto prev = nodes[node].prev;
+
+	if (next != None)
+	{
+		nodes[next].prev = prev;
+	}
+	else
+	{
+		tail = prev;
+	}
+
+	if (prev != None)
+	{
+		nodes[prev].next = next;
+	}
+	else
+	{
+		head = next;
+	}
+
+	count--;
+	release(node);
+	return val;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+	@brief  Cheap pseudo-random number from a per-thread xorshift generator
+
+	Meant for spreading threads over slots or sub-queues, not for anything that needs good randomness.
+	Each thread's state is seeded from it's own address, so threads start from different points.
+	@retval uint32_t next number of the calling thread's sequence, never 0
+**/
+inline std::uint32_t threadRandom() noexcept
+{
+	thread_local std::uint32_t state = static_cast<std::uint32_t>(reinterpret_cast<std::uintptr_t>(&state) >> 4) | 1;
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
@@ -0,0 +1,666 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+
+	@class   TieredList
+	@brief   Doubly-linked list that keeps frequently accessed values in a small contiguous hot tier
+
+	@details ~ In a long-lived list a few values are looked up constantly and the rest sit idle, yet every search walks past
+			   the idle ones. TieredList keeps the list order in compact index-linked entries and the values themselves in
+			   one of two packed arrays: a hot tier of at most hotCapacity values, searched first, and a cold tier holding
+			   the rest. Iteration always follows list order, whatever the tier of each value.
+			   find() and touch() count accesses per entry. A cold value that reaches promoteHits accesses moves to the hot
+			   tier if it has room; after every 32 hot tier sizes' worth of accesses all counts are halved (lazily, by an epoch
+			   stamp) and hot values that fell below half of promoteHits move back to the cold tier, so promotion and demotion
+			   cost amortized O(1) per access. Moving a value between tiers moves the value only, entries never move.
+			   Iterators refer to entries and stay valid until their value is erased; references and pointers to values are
+			   invalidated by push_front(), push_back() (the cold tier may grow), find(), contains(), touch() and any removal.
+	@tparam  TValue - type of list's values, must be equality comparable for find()
+
+**/
+template<typename TValue>
+class TieredList
+{
+public:
+	using value_type = TValue;
+	using reference = value_type&;
+	using const_reference = const value_type&;
+	using size_type = std::size_t;
+
+	class iterator;
+
+	/**
+		@brief Construct an empty list
+		@param hotCapacity - maximum number of values in the hot tier
+		@param promoteHits - accesses after which a cold value is promoted to the hot tier, at least 2
+	**/
+	explicit TieredList(size_type hotCapacity = 64, unsigned promoteHits = 4);
+
+	/**
+		@brief Construct a list taking over another list's values, the other list is left empty
+
+		Performs in O(1) constant time. Iterators of the other list are invalidated.
+	**/
+	TieredList(TieredList&& other) noexcept;
+
+	TieredList(const TieredList&) = delete;
+	TieredList& operator=(const TieredList&) = delete;
+
+	/**
+		@brief  Returns size of the list
+
+		Performs in O(1) constant time
+	**/
+	size_type size() const noexcept;
+
+	/**
+		@brief  Determines if the list is empty
+
+		Performs in O(1) constant time
+	**/
+	bool empty() const noexcept;
+
+	/**
+		@brief  Number of values in the hot tier
+	**/
+	size_type hotSize() const noexcept;
+
+	/**
+		@brief Add an element to the front of the list, new values start in the cold tier
+
+		Performs in O(1) amortized constant time
+		@param val - value to add
+	**/
+	void push_front(const TValue& val);
+
+	/**
+		@brief Add an element to the end of the list, new values start in the cold tier
+
+		Performs in O(1) amortized constant time
+		@param val - value to add
+	**/
+	void push_back(const TValue& val);
+
+	/**
+		@brief  Return the value at the beginning of the list
+		@exception std::runtime_error if list is empty
+	**/
+	reference front();
+
+	/**
+		@brief  Return the value at the end of the list
+		@exception std::runtime_error if list is empty
+	**/
+	reference back();
+
+	/**
+		@brief  Removes the value at the beginning of the list and returns it
+
+		Performs in O(1) constant time
+		@exception std::runtime_error if list is empty
+	**/
+	value_type pop_front();
+
+	/**
+		@brief  Removes the value at the end of the list and returns it
+
+		Performs in O(1) constant time
+		@exception std::runtime_error if list is empty
+	**/
+	value_type pop_back();
+
+	/**
+		@brief  Search the hot tier, then the cold tier, for a value and count an access to it
+
+		Performs in O(h) time for a value in the hot tier, where h = the size of the hot tier, O(n) otherwise
+		@param  val - value to search for
+		@retval iterator pointing at the found value, or end() if the value is not in the list
+	**/
+	iterator find(const TValue& val);
+
+	/**
+		@brief  Determines if the list contains a value, counting an access like find() does
+	**/
+	bool contains(const TValue& val);
+
+	/**
+		@brief  Count an access to a value, possibly promoting it to the hot tier
+
+		Performs in O(1) amortized constant time
+		@param  pos - valid, dereferenceable iterator into this list
+		@retval reference to the value in it's new place
+	**/
+	reference touch(iterator pos);
+
+	/**
+		@brief  Removes the value the iterator points at
+
+		Performs in O(1) constant time
+		@param  pos - valid, dereferenceable iterator into this list
+		@retval iterator pointing at the value following the removed one
+	**/
+	iterator erase(iterator pos);
+
+	/**
+		@brief Removes all values of the list
+	**/
+	void clear() noexcept;
+
+	/**
+		@brief Call a function on every value of the hot tier, in no particular order
+		@param func - callable taking TValue&
+	**/
+	template<typename TFunc>
+	void forEachHot(TFunc&& func);
+
+	iterator begin() noexcept;
+	iterator end() noexcept;
+
+	/**
+		@brief Get string representation of the list's values in list order suitable for display
+	**/
+	std::string toString() const;
+
+private:
+	static constexpr std::uint32_t None = UINT32_MAX;
+	static constexpr std::uint16_t MaxHits = UINT16_MAX;
+
+	// position of a value in the list, linked by index
+	struct Entry
+	{
+		std::uint32_t next;
+		std::uint32_t prev;
+		// index of the value in it's tier
+		std::uint32_t slot;
+		// aging epoch hits was last brought up to date in
+		std::uint32_t epoch;
+		std::uint16_t hits;
+		bool hot;
+	};
+
+	// a value with the entry it belongs to, tiers are packed arrays of these
+	struct Slot
+	{
+		TValue value;
+		std::uint32_t entry;
+	};
+
+	std::vector<Entry> entries;
+	std::uint32_t head;
+	std::uint32_t tail;
+	// recycled entries, linked through next
+	std::uint32_t freeEntries;
+	size_type count;
+
+	std::vector<Slot> hot;
+	std::vector<Slot> cold;
+
+	const size_type hotCapacity;
+	const unsigned promoteHits;
+
+	std::uint32_t epoch;
+	// accesses since the counts were last halved
+	size_type accesses;
+
+	std::vector<Slot>& tier(const Entry& entry) noexcept;
+	const std::vector<Slot>& tier(const Entry& entry) const noexcept;
+	TValue& valueOf(std::uint32_t index) noexcept;
+
+	// Add val in the cold tier and link it's entry before the entry at index, None appends
+	void add(const TValue& val, std::uint32_t before);
+	// Unlink an entry, move it's value out and recycle both
+	TValue remove(std::uint32_t index);
+
+	// Remove a slot from a tier by moving the tier's last slot into it
+	void removeSlot(std::vector<Slot>& from, std::uint32_t slot) noexcept;
+	// Move an entry's value to the other tier
+	void moveTier(std::uint32_t index);
+
+	// Apply the halvings the entry missed since it was last updated
+	void decay(Entry& entry) noexcept;
+	void access(std::uint32_t index);
+	// Halve all counts and demote hot values that cooled down
+	void age();
+};
+
+/**
+	@class  TieredList::iterator
+	@brief  Bidirectional iterator over a TieredList in list order
+**/
+template<typename TValue>
+class TieredList<TValue>::iterator
+{
+public:
+	using iterator_category = std::bidirectional_iterator_tag;
+	using value_type = TValue;
+	using difference_type = std::ptrdiff_t;
+	using pointer = value_type*;
+	using reference = value_type&;
+
+	constexpr iterator() noexcept
+		: list(nullptr)
+		, index(None)
+	{}
+
+	reference operator*() const noexcept
+	{
+		return list->valueOf(index);
+	}
+
+	pointer operator->() const noexcept
+	{
+		return &list->valueOf(index);
+	}
+
+	iterator& operator++() noexcept
+	{
+		index = list->entries[index].next;
+		return *this;
+	}
+
+	iterator operator++(int) noexcept
+	{
+		auto it = *this;
+		++*this;
+		return it;
+	}
+
+	iterator& operator--() noexcept
+	{
+		index = index == None ? list->tail : list->entries[index].prev;
+		return *this;
+	}
+
+	iterator operator--(int) noexcept
+	{
+		auto it = *this;
+		--*this;
+		return it;
+	}
+
+	bool operator==(const iterator& other) const noexcept
+	{
+		return index == other.index && list == other.list;
+	}
+
+	bool operator!=(const iterator& other) const noexcept
+	{
+		return !(*this == other);
+	}
+
+private:
+	TieredList* list;
+	std::uint32_t index;
+
+	constexpr iterator(TieredList* list, std::uint32_t index) noexcept
+		: list(list)
+		, index(index)
+	{}
+
+	friend class TieredList<TValue>;
+};
+
+template<typename TValue>
+inline TieredList<TValue>::TieredList(size_type hotCapacity, unsigned promoteHits)
+	: entries()
+	, head(None)
+	, tail(None)
+	, freeEntries(None)
+	, count(0)
+	, hot()
+	, cold()
+	, hotCapacity(hotCapacity)
+	, promoteHits(promoteHits < 2 ? 2 : (promoteHits > MaxHits ? MaxHits : promoteHits))
+	, epoch(0)
+	, accesses(0)
+{
+	hot.reserve(hotCapacity);
+}
+
+template<typename TValue>
+inline TieredList<TValue>::TieredList(TieredList&& other) noexcept
+	: entries(std::move(other.entries))
+	, head(std::exchange(other.head, None))
+	, tail(std::exchange(other.tail, None))
+	, freeEntries(std::exchange(other.freeEntries, None))
+	, count(std::exchange(other.count, 0))
+	, hot(std::move(other.hot))
+	, cold(std::move(other.cold))
+	, hotCapacity(other.hotCapacity)
+	, promoteHits(other.promoteHits)
+	, epoch(std::exchange(other.epoch, 0))
+	, accesses(std::exchange(other.accesses, 0))
+{}
+
+template<typename TValue>
+inline std::size_t TieredList<TValue>::size() const noexcept
+{
+	return count;
+}
+
+template<typename TValue>
+inline bool TieredList<TValue>::empty() const noexcept
+{
+	return count == 0;
+}
+
+template<typename TValue>
+inline std::size_t TieredList<TValue>::hotSize() const noexcept
+{
+	return hot.size();
+}
+
+template<typename TValue>
+inline void TieredList<TValue>::push_front(const TValue& val)
+{
+	add(val, head);
+}
+
+template<typename TValue>
+inline void TieredList<TValue>::push_back(const TValue& val)
+{
+	add(val, None);
+}
+
+template<typename TValue>
+inline TValue& TieredList<TValue>::front()
+{
+	if (head == None) throw std::runtime_error("list is empty");
+	return valueOf(head);
+}
+
+template<typename TValue>
+inline TValue& TieredList<TValue>::back()
+{
+	if (tail == None) throw std::runtime_error("list is empty");
+	return valueOf(tail);
+}
+
+template<typename TValue>
+inline TValue TieredList<TValue>::pop_front()
+{
+	if (head == None) throw std::runtime_error("cannot remove from empty list");
+	return remove(head);
+}
+
+template<typename TValue>
+inline TValue TieredList<TValue>::pop_back()
+{
+	if (tail == None) throw std::runtime_error("cannot remove from empty list");
+	return remove(tail);
+}
+
+template<typename TValue>
+inline typename TieredList<TValue>::iterator TieredList<TValue>::find(const TValue& val)
+{
+	for (auto tierSlots : { &hot, &cold })
+	{
+		for (auto& slot : *tierSlots)
+		{
+			if (slot.value == val)
+			{
+				auto index = slot.entry;
+				access(index);
+				return iterator(this, index);
+			}
+		}
+	}
+	return end();
+}
+
+template<typename TValue>
+inline bool TieredList<TValue>::contains(const TValue& val)
+{
+	return find(val) != end();
+}
+
+template<typename TValue>
+inline TValue& TieredList<TValue>::touch(iterator pos)
+{
+	access(pos.index);
+	return valueOf(pos.index);
+}
+
+template<typename TValue>
+inline typename TieredList<TValue>::iterator TieredList<TValue>::erase(iterator pos)
+{
+	auto next = entries[pos.index].next;
+	remove(pos.index);
+	return iterator(this, next);
+}
+
+template<typename TValue>
+inline void TieredList<TValue>::clear() noexcept
+{
+	entries.clear();
+	hot.clear();
+	cold.clear();
+	head = None;
+	tail = None;
+	freeEntries = None;
+	count = 0;
+	accesses = 0;
+}
+
+template<typename TValue>
+template<typename TFunc>
+inline void TieredList<TValue>::forEachHot(TFunc&& func)
+{
+	for (auto& slot : hot)
+	{
+		func(slot.value);
+	}
+}
+
+template<typename TValue>
+inline typename TieredList<TValue>::iterator TieredList<TValue>::begin() noexcept
+{
+	return iterator(this, head);
+}
+
+template<typename TValue>
+inline typename TieredList<TValue>::iterator TieredList<TValue>::end() noexcept
+{
+	return iterator(this, None);
+}
+
+template<typename TValue>
+inline std::string TieredList<TValue>::toString() const
+{
+	std::stringstream ss;
+	for (auto n = head; n != None; n = entries[n].next)
+	{
+		ss << '[' << tier(entries[n])[entries[n].slot].value << ']';
+		if (entries[n].next != None)
+		{
+			ss << "<->";
+		}
+	}
+	return ss.str();
+}
+
+template<typename TValue>
+inline std::vector<typename TieredList<TValue>::Slot>& TieredList<TValue>::tier(const Entry& entry) noexcept
+{
+	return entry.hot ? hot : cold;
+}
+
+template<typename TValue>
+inline const std::vector<typename TieredList<TValue>::Slot>& TieredList<TValue>::tier(const Entry& entry) const noexcept
+{
+	return entry.hot ? hot : cold;
+}
+
+template<typename TValue>
+inline TValue& TieredList<TValue>::valueOf(std::uint32_t index) noexcept
+{
+	auto& entry = entries[index];
+	return tier(entry)[entry.slot].value;
+}
+
+template<typename TValue>
+inline void TieredList<TValue>::add(const TValue& val, std::uint32_t before)
+{
+	std::uint32_t index;
+	if (freeEntries != None)
+	{
+		index = freeEntries;
+		freeEntries = entries[index].next;
+	}
+	else
+	{
+		if (entries.size() >= None) throw std::runtime_error("list is full");
+		entries.push_back(Entry());
+		index = static_cast<std::uint32_t>(entries.size() - 1);
+	}
+
+	try
+	{
+		cold.push_back(Slot{ val, index });
+	}
+	catch (...)
+	{
+		entries[index].next = freeEntries;
+		freeEntries = index;
+		throw;
+	}
+
+	auto& entry = entries[index];
+	entry.slot = static_cast<std::uint32_t>(cold.size() - 1);
+	entry.epoch = epoch;
+	entry.hits = 0;
+	entry.hot = false;
+
+	entry.next = before;
+	entry.prev = before == None ? tail : entries[before].prev;
+	if (entry.prev != None)
+	{
+		entries[entry.prev].next = index;
+	}
+	else
+	{
+		head = index;
+	}
+	if (before != None)
+	{
+		entries[before].prev = index;
+	}
+	else
+	{
+		tail = index;
+	}
+	count++;
+}
+
+template<typename TValue>
+inline TValue TieredList<TValue>::remove(std::uint32_t index)
+{
+	auto& entry = entries[index];
+	auto& slots = tier(entry);
+	auto val = std::move(slots[entry.slot].value);
+	removeSlot(slots, entry.slot);
+
+	if (entry.prev != None)
+	{
+		entries[entry.prev].next = entry.next;
+	}
+	else
+	{
+		head = entry.next;
+	}
+	if (entry.next != None)
+	{
+		entries[entry.next].prev = entry.prev;
+	}
+	else
+	{
+		tail = entry.prev;
+	}
+
+	entry.next = freeEntries;
+	freeEntries = index;
+	count--;
+	return val;
+}
+
+template<typename TValue>
+inline void TieredList<TValue>::removeSlot(std::vector<Slot>& from, std::uint32_t slot) noexcept
+{
+	if (slot + 1 != from.size())
+	{
+		from[slot] = std::move(from.back());
+		entries[from[slot].entry].slot = slot;
+	}
+	from.pop_back();
+}
+
+template<typename TValue>
+inline void TieredList<TValue>::moveTier(std::uint32_t index)
+{
+	auto& entry = entries[index];
+	auto& from = tier(entry);
+	auto& to = entry.hot ? cold : hot;
+	to.push_back(Slot{ std::move(from[entry.slot].value), index });
+	removeSlot(from, entry.slot);
+	entry.slot = static_cast<std::uint32_t>(to.size() - 1);
+	entry.hot = !entry.hot;
+}
+
+template<typename TValue>
+inline void TieredList<TValue>::decay(Entry& entry) noexcept
+{
+	auto missed = epoch - entry.epoch;
+	entry.hits = missed >= 16 ? 0 : static_cast<std::uint16_t>(entry.hits >> missed);
+	entry.epoch = epoch;
+}
+
+template<typename TValue>
+inline void TieredList<TValue>::access(std::uint32_t index)
+{
+	auto& entry = entries[index];
+	decay(entry);
+	if (entry.hits < MaxHits)
+	{
+		entry.hits++;
+	}
+	if (!entry.hot && entry.hits >= promoteHits && hot.size() < hotCapacity)
+	{
+		moveTier(index);
+	}
+
+	// halving after 32 hot tiers' worth of accesses gives values ranked up to hotCapacity time to reach promoteHits,
+	// and keeps the aging scan of the hot tier amortized O(1)
+	if (++accesses >= 32 * hotCapacity + 64)
+	{
+		age();
+	}
+}
+
+template<typename TValue>
+inline void TieredList<TValue>::age()
+{
+	epoch++;
+	accesses = 0;
+	// backwards, so the slots moved in by removeSlot() were already visited
+	for (auto i = hot.size(); i-- > 0; )
+	{
+		auto index = hot[i].entry;
+		auto& entry = entries[index];
+		decay(entry);
+		// demoting below half the promotion count keeps values at the threshold from flapping between tiers
+		if (entry.hits * 2u < promoteHits)
+		{
+			moveTier(index);
+		}
+	}
+}
@@ -0,0 +1,534 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "NodeChunks.h"
+
+/**
+
+	@class   TimingWheel
+	@brief   Hierarchical hashed timing wheel of timers holding values, with O(1) schedule and cancel
+
+	@details ~ Keeping timers in a sorted list makes scheduling O(n). The wheel instead hashes each timer by it's expiry tick
+			   into one of Levels rings of 2^SlotBits slots: level 0 holds timers due within 2^SlotBits ticks, one slot per tick,
+			   level 1 timers due within 2^(2*SlotBits) ticks, one slot per 2^SlotBits ticks, and so on. Every slot is an intrusive
+			   doubly-linked ring of timer nodes, so schedule() and cancel() are a few pointer stores.
+			   advance() moves the wheel one tick at a time, skipping straight to the next cascade while the lower levels are
+			   empty. Whenever a level's ring wraps around, the next slot of the level above is cascaded: spliced off in one step
+			   and it's timers re-hashed into lower levels. The level 0 slot of the new tick is then spliced whole onto the list of
+			   due timers, which are handed to the callback in expiry order within the tick. A callback that throws leaves the
+			   remaining due timers queued for the next advance(). Timers further out than the whole wheel wait in the top level
+			   and are re-hashed until they fit. Timer handles carry the node's generation, so cancelling a timer that already
+			   expired or was cancelled is detected and does nothing. Node memory is allocated in chunks and recycled, a wheel in
+			   steady state does not allocate.
+	@tparam  TValue   - type of the values carried by timers
+	@tparam  SlotBits - log2 of the number of slots per level
+	@tparam  Levels   - number of levels, at least 2, the wheel spans 2^(SlotBits*Levels) ticks
+
+**/
+template<typename TValue, std::size_t SlotBits = 8, std::size_t Levels = 4>
+class TimingWheel
+{
+	static_assert(SlotBits > 0 && Levels > 1 && SlotBits * Levels < 64, "the wheel needs at least two levels and must span fewer than 2^64 ticks");
+
+public:
+	using value_type = TValue;
+	using size_type = std::size_t;
+	using tick_type = std::uint64_t;
+
+	class Timer;
+
+	/**
+		@brief Construct an empty wheel at tick 0
+	**/
+	TimingWheel() noexcept;
+
+	~TimingWheel();
+
+	TimingWheel(const TimingWheel&) = delete;
+	TimingWheel& operator=(const TimingWheel&) = delete;
+
+	/**
+		@brief  Returns number of scheduled timers, including due timers not handed out yet
+
+		Performs in O(1) constant time
+	**/
+	size_type size() const noexcept;
+
+	/**
+		@brief  Determines if no timer is scheduled
+
+		Performs in O(1) constant time
+	**/
+	bool empty() const noexcept;
+
+	/**
+		@brief  Current tick of the wheel
+	**/
+	tick_type now() const noexcept;
+
+	/**
+		@brief  Schedule a timer carrying a value
+
+		Performs in O(1) amortized constant time
+		@param  delay - ticks from now until the timer expires, 0 counts as 1
+		@param  val   - value handed to the callback of advance() when the timer expires
+		@retval Timer handle for cancel()
+	**/
+	Timer schedule(tick_type delay, const TValue& val);
+	Timer schedule(tick_type delay, TValue&& val);
+
+	/**
+		@brief  Cancel a scheduled timer, destroying it's value
+
+		Performs in O(1) constant time
+		@param  timer - handle returned by schedule()
+		@retval bool true if the timer was cancelled, false if it already expired or was cancelled
+	**/
+	bool cancel(const Timer& timer) noexcept;
+
+	/**
+		@brief  Determines if a timer is still scheduled
+	**/
+	bool pending(const Timer& timer) const noexcept;
+
+	/**
+		@brief  Move the wheel forward, handing the values of expired timers to a callback
+
+		Performs in O(k) time, where k = the number of expired and cascaded timers, plus O(1) per tick while level 0 holds
+		timers; stretches without such ticks are skipped up to the next cascade at once
+		@param  ticks   - number of ticks to advance by
+		@param  expired - callable taking TValue&, called once per expired timer, it may schedule and cancel timers
+		@retval size_t number of timers that expired
+	**/
+	template<typename TFunc>
+	size_type advance(tick_type ticks, TFunc&& expired);
+
+	/**
+		@brief  Move the wheel forward by a single tick, same as advance(1, expired)
+	**/
+	template<typename TFunc>
+	size_type tick(TFunc&& expired);
+
+	/**
+		@brief Cancel all timers, node memory is kept for reuse
+
+		Performs in O(n + s) linear time, where s = the number of slots
+	**/
+	void clear() noexcept;
+
+private:
+	static constexpr std::size_t SlotCount = std::size_t(1) << SlotBits;
+	static constexpr tick_type SlotMask = SlotCount - 1;
+	static constexpr tick_type Span = tick_type(1) << (SlotBits * Levels);
+
+	struct Link
+	{
+		Link* next;
+		Link* prev;
+	};
+
+	// forward declaration (implementation below)
+	struct Node;
+
+	// slot rings, each slot is a sentinel linked to itself while empty
+	Link slots[Levels][SlotCount];
+	// timers of the current tick not handed to the callback yet
+	Link due;
+
+	tick_type current;
+	size_type count;
+	// nodes per level, lets advance() skip ticks while the lower levels are empty
+	size_type levelCount[Levels];
+
+	// recycled nodes, linked through next
+	Link* freeList;
+	NodeChunks<Node> chunks;
+
+	static void reset(Link& ring) noexcept;
+	static void linkBefore(Link* link, Link* node) noexcept;
+	static void unlink(Link* node) noexcept;
+	// Move all nodes of ring to the end of target, leaving ring empty
+	static void splice(Link& ring, Link& target) noexcept;
+
+	template<typename TArg>
+	Timer add(tick_type delay, TArg&& val);
+
+	// Hash a node into the slot for it's expiry as seen from the current tick
+	void place(Node* node) noexcept;
+
+	// Re-hash every node of a slot into lower levels
+	void cascade(Link& slot) noexcept;
+
+	// Destroy a node's value and return it to the free list
+	void release(Node* node) noexcept;
+
+	// Take a node from the free list, allocating a new chunk if it is empty
+	Node* allocateNode();
+
+	// Hand the due timers to the callback until none are left
+	template<typename TFunc>
+	size_type expire(TFunc& expired);
+};
+
+/**
+	@struct Node
+	@brief  Represents a timer in the TimingWheel, the value is only constructed while the timer is scheduled
+**/
+template<typename TValue, std::size_t SlotBits, std::size_t Levels>
+struct TimingWheel<TValue, SlotBits, Levels>::Node : Link
+{
+	tick_type expiry;
+	// level of the slot holding the node, due nodes keep level 0
+	std::size_t level;
+	// bumped every time the node is freed, so stale handles do not match
+	std::uint64_t generation = 0;
+	alignas(TValue) unsigned char storage[sizeof(TValue)];
+
+	TValue& value() noexcept
+	{
+		return *std::launder(reinterpret_cast<TValue*>(storage));
+	}
+};
+
+/**
+	@class  TimingWheel::Timer
+	@brief  Handle of a scheduled timer, a default constructed handle refers to no timer
+**/
+template<typename TValue, std::size_t SlotBits, std::size_t Levels>
+class TimingWheel<TValue, SlotBits, Levels>::Timer
+{
+public:
+	constexpr Timer() noexcept
+		: node(nullptr)
+		, generation(0)
+	{}
+
+private:
+	Node* node;
+	std::uint64_t generation;
+
+	constexpr Timer(Node* node, std::uint64_t generation) noexcept
+		: node(node)
+		, generation(generation)
+	{}
+
+	friend class TimingWheel<TValue, SlotBits, Levels>;
+};
+
+template<typename TValue, std::size_t SlotBits, std::size_t Levels>
+inline TimingWheel<TValue, SlotBits, Levels>::TimingWheel() noexcept
+	: current(0)
+	, count(0)
+	, levelCount()
+	, freeList(nullptr)
+	, chunks()
+{
+	for (auto& level : slots)
+	{
+		for (auto& slot : level)
+		{
+			reset(slot);
+		}
+	}
+	reset(due);
+}
+
+template<typename TValue, std::size_t SlotBits, std::size_t Levels>
+inline TimingWheel<TValue, SlotBits, Levels>::~TimingWheel()
+{
+	clear();
+}
+
+template<typename TValue, std::size_t SlotBits, std::size_t Levels>
+inline std::size_t TimingWheel<TValue, SlotBits, Levels>::size() const noexcept
+{
+	return count;
+}
+
+template<typename TValue, std::size_t SlotBits, std::size_t Levels>
+inline bool TimingWheel<TValue, SlotBits, Levels>::empty() const noexcept
+{
+	return count == 0;
+}
+
+template<typename TValue, std::size_t SlotBits, std::size_t Levels>
+inline std::uint64_t TimingWheel<TValue, SlotBits, Levels>::now() const noexcept
+{
+	return current;
+}
+
+template<typename TValue, std::size_t SlotBits, std::size_t Levels>
+inline TimingWheel<TValue, SlotBits, Levels>::Timer TimingWheel<TValue, SlotBits, Levels>::schedule(tick_type delay, const TValue& val)
+{
+	return add(delay, val);
+}
+
+template<typename TValue, std::size_t SlotBits, std::size_t Levels>
+inline TimingWheel<TValue, SlotBits, Levels>::Timer TimingWheel<TValue, SlotBits, Levels>::schedule(tick_type delay, TValue&& val)
+{
+	return add(delay, std::move(val));
+}
+
+template<typename TValue, std::size_t SlotBits, std::size_t Levels>
+inline bool TimingWheel<TValue, SlotBits, Levels>::cancel(const Timer& timer) noexcept
+{
+	if (!pending(timer))
+	{
+		return false;
+	}
+	unlink(timer.node);
+	levelCount[timer.node->level]--;
+	release(timer.node);
+	count--;
+	return true;
+}
+
+template<typename TValue, std::size_t SlotBits, std::size_t Levels>
+inline bool TimingWheel<TValue, SlotBits, Levels>::pending(const Timer& timer) const noexcept
+{
+	// node memory is never freed while the wheel lives, so a stale handle can still be compared
+	return timer.node != nullptr && timer.node->generation == timer.generation;
+}
+
+template<typename TValue, std::size_t SlotBits, std::size_t Levels>
+template<typename TFunc>
+inline std::size_t TimingWheel<TValue, SlotBits, Levels>::advance(tick_type ticks, TFunc&& expired)
+{
+	// left over from a callback that threw
+	size_type expiredCount = expire(expired);
+
+	for (; ticks > 0; ticks--)
+	{
+		if (count == 0)
+		{
+			// nothing to cascade or expire
+			current += ticks;
+			break;
+		}
+
+		// with the lowest levels empty nothing happens before the next cascade of the lowest occupied level
+		std::size_t lowest = 0;
+		while (lowest + 1 < Levels && levelCount[lowest] == 0)
+		{
+			lowest++;
+		}
+		if (lowest > 0)
+		{
+			auto period = tick_type(1) << (SlotBits * lowest);
+			auto idle = period - 1 - (current & (period - 1));
+			if (idle >= ticks)
+			{
+				current += ticks;
+				break;
+			}
+			current += idle;
+			ticks -= idle;
+		}
+
+		current++;
+		// a level cascades when all levels below it wrapped around
+		for (std::size_t level = 1; level < Levels; level++)
+		{
+			auto shift = SlotBits * level;
+			if ((current & ((tick_type(1) << shift) - 1)) != 0)
+			{
+				break;
+			}
+			cascade(slots[level][(current >> shift) & SlotMask]);
+		}
+
+		splice(slots[0][current & SlotMask], due);
+		expiredCount += expire(expired);
+	}
+	return expiredCount;
+}
+
+template<typename TValue, std::size_t SlotBits, std::size_t Levels>
+template<typename TFunc>
+inline std::size_t TimingWheel<TValue, SlotBits, Levels>::tick(TFunc&& expired)
+{
+	return advance(1, expired);
+}
+
+template<typename TValue, std::size_t SlotBits, std::size_t Levels>
+inline void TimingWheel<TValue, SlotBits, Levels>::clear() noexcept
+{
+	auto clearRing = [this](Link& ring)
+	{
+		auto n = ring.next;
+		while (n != &ring)
+		{
+			auto next = n->next;
+			release(static_cast<Node*>(n));
+			n = next;
+		}
+		reset(ring);
+	};
+
+	if (count != 0)
+	{
+		for (auto& level : slots)
+		{
+			for (auto& slot : level)
+			{
+				clearRing(slot);
+			}
+		}
+		clearRing(due);
+	}
+	for (auto& n : levelCount)
+	{
+		n = 0;
+	}
+	count = 0;
+}
+
+template<typename TValue, std::size_t SlotBits, std::size_t Levels>
+inline void TimingWheel<TValue, SlotBits, Levels>::reset(Link& ring) noexcept
+{
+	ring.next = &ring;
+	ring.prev = &ring;
+}
+
+template<typename TValue, std::size_t SlotBits, std::size_t Levels>
+inline void TimingWheel<TValue, SlotBits, Levels>::linkBefore(Link* link, Link* node) noexcept
+{
+	node->next = link;
+	node->prev = link->prev;
+	link->prev->next = node;
+	link->prev = node;
+}
+
+template<typename TValue, std::size_t SlotBits, std::size_t Levels>
+inline void TimingWheel<TValue, SlotBits, Levels>::unlink(Link* node) noexcept
+{
+	node->prev->next = node->next;
+	node->next->prev = node->prev;
+}
+
+template<typename TValue, std::size_t SlotBits, std::size_t Levels>
+inline void TimingWheel<TValue, SlotBits, Levels>::splice(Link& ring, Link& target) noexcept
+{
+	if (ring.next == &ring)
+	{
+		return;
+	}
+	auto first = ring.next;
+	auto last = ring.prev;
+	first->prev = target.prev;
+	target.prev->next = first;
+	last->next = &target;
+	target.prev = last;
+	reset(ring);
+}
+
+template<typename TValue, std::size_t SlotBits, std::size_t Levels>
+template<typename TArg>
+inline TimingWheel<TValue, SlotBits, Levels>::Timer TimingWheel<TValue, SlotBits, Levels>::add(tick_type delay, TArg&& val)
+{
+	auto node = allocateNode();
+	try
+	{
+		::new (static_cast<void*>(node->storage)) TValue(std::forward<TArg>(val));
+	}
+	catch (...)
+	{
+		node->next = freeList;
+		freeList = node;
+		throw;
+	}
+	node->expiry = current + (delay == 0 ? 1 : delay);
+	place(node);
+	count++;
+	return Timer(node, node->generation);
+}
+
+template<typename TValue, std::size_t SlotBits, std::size_t Levels>
+inline void TimingWheel<TValue, SlotBits, Levels>::place(Node* node) noexcept
+{
+	auto diff = node->expiry - current;
+	auto at = node->expiry;
+	std::size_t level = 0;
+	if (diff >= Span)
+	{
+		// beyond the wheel: park in the top level's furthest slot, cascading re-hashes it later
+		at = current + Span - 1;
+		level = Levels - 1;
+	}
+	else
+	{
+		while ((diff >> (SlotBits * (level + 1))) != 0)
+		{
+			level++;
+		}
+	}
+	node->level = level;
+	levelCount[level]++;
+	linkBefore(&slots[level][(at >> (SlotBits * level)) & SlotMask], node);
+}
+
+template<typename TValue, std::size_t SlotBits, std::size_t Levels>
+inline void TimingWheel<TValue, SlotBits, Levels>::cascade(Link& slot) noexcept
+{
+	Link moving;
+	reset(moving);
+	splice(slot, moving);
+
+	auto n = moving.next;
+	while (n != &moving)
+	{
+		auto next = n->next;
+		levelCount[static_cast<Node*>(n)->level]--;
+		place(static_cast<Node*>(n));
+		n = next;
+	}
+}
+
+template<typename TValue, std::size_t SlotBits, std::size_t Levels>
+inline void TimingWheel<TValue, SlotBits, Levels>::release(Node* node) noexcept
+{
+	if constexpr (!std::is_trivially_destructible_v<TValue>)
+	{
+		node->value().~TValue();
+	}
+	node->generation++;
+	node->next = freeList;
+	freeList = node;
+}
+
+template<typename TValue, std::size_t SlotBits, std::size_t Levels>
+inline TimingWheel<TValue, SlotBits, Levels>::Node* TimingWheel<TValue, SlotBits, Levels>::allocateNode()
+{
+	if (freeList == nullptr)
+	{
+		freeList = chunks.grow();
+	}
+
+	auto node = static_cast<Node*>(freeList);
+	freeList = node->next;
+	return node;
+}
+
+template<typename TValue, std::size_t SlotBits, std::size_t Levels>
+template<typename TFunc>
+inline std::size_t TimingWheel<TValue, SlotBits, Levels>::expire(TFunc& expired)
+{
+	size_type expiredCount = 0;
+	while (due.next != &due)
+	{
+		// the node is gone before the callback runs, so it can cancel any other due timer
+		auto node = static_cast<Node*>(due.next);
+		TValue val = std::move(node->value());
+		unlink(node);
+		levelCount[0]--;
+		release(node);
+		count--;
+		expiredCount++;
+		expired(val);
+	}
+	return expiredCount;
+}
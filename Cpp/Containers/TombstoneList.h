@@ -0,0 +1,570 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include "NodePool.h"
+
+/**
+
+	@class   TombstoneList
+	@brief   Doubly-linked list whose erase() only marks nodes deleted, unlinking and freeing them later in a batch
+
+	@details ~ Erasing many values during a scan unlinks and frees nodes one by one, interleaving pointer fix-ups in the
+			   neighbours and allocator calls with the scan itself. Here erase() sets a tombstone on the node and iterators
+			   step over tombstoned nodes. Once tombstones make up more than the compaction ratio of all nodes, compact()
+			   runs: one pass unlinks every tombstoned node, destroys it's value and frees it. Nodes at either end are still
+			   unlinked at once, so the first and last node are always live and front()/back()/pop_front()/pop_back()
+			   stay O(1).
+			   Values stay constructed until their node is compacted. Iterators to live values stay valid across compaction,
+			   iterators to erased values are invalid as soon as they are erased, like with LinkedList.
+			   Nodes live in a NodePool owned by the list, so freeing a batch of nodes only pushes them onto the pool's free list.
+	@tparam  TValue - type of list's values
+
+**/
+template<typename TValue>
+class TombstoneList
+{
+public:
+	using value_type = TValue;
+	using reference = value_type&;
+	using const_reference = const value_type&;
+	using size_type = std::size_t;
+
+	class iterator;
+
+	/**
+		@brief Construct an empty list
+		@param compactionRatio - share of tombstoned nodes among all nodes above which erase() compacts the list;
+								 0 compacts on every erase, 1 or more only compacts on explicit compact() calls
+	**/
+	explicit TombstoneList(double compactionRatio = 0.25) noexcept;
+	~TombstoneList();
+
+	TombstoneList(const TombstoneList&) = delete;
+	TombstoneList& operator=(const TombstoneList&) = delete;
+
+	/**
+		@brief  Returns number of live values in the list
+
+		Performs in O(1) constant time
+	**/
+	size_type size() const noexcept;
+
+	/**
+		@brief  Determines if the list holds no live values
+
+		Performs in O(1) constant time
+	**/
+	bool empty() const noexcept;
+
+	/**
+		@brief  Number of erased nodes waiting for compaction
+	**/
+	size_type tombstones() const noexcept;
+
+	double compactionRatio() const noexcept;
+
+	/**
+		@brief Set the share of tombstoned nodes above which erase() compacts the list
+	**/
+	void setCompactionRatio(double ratio) noexcept;
+
+	/**
+		@brief Add an element to the front of the list
+
+		Performs in O(1) constant time
+		@param val - value to add
+	**/
+	void push_front(const TValue& val);
+
+	/**
+		@brief Add an element to the end of the list
+
+		Performs in O(1) constant time
+		@param val - value to add
+	**/
+	void push_back(const TValue& val);
+
+	/**
+		@brief  Return the value at the beginning of the list
+		@exception std::runtime_error if list is empty
+	**/
+	reference front();
+
+	/**
+		@brief  Return the value at the end of the list
+		@exception std::runtime_error if list is empty
+	**/
+	reference back();
+
+	/**
+		@brief  Removes the value at the beginning of the list and returns it
+
+		Performs in O(1) amortized constant time
+		@exception std::runtime_error if list is empty
+	**/
+	value_type pop_front();
+
+	/**
+		@brief  Removes the value at the end of the list and returns it
+
+		Performs in O(1) amortized constant time
+		@exception std::runtime_error if list is empty
+	**/
+	value_type pop_back();
+
+	/**
+		@brief  Search the list for the first live node holding a value
+
+		Performs in O(n) linear time, where n = the number of nodes including tombstoned ones
+		@param  val - value to search for
+		@retval iterator pointing at the found value, or end() if the value is not in the list
+	**/
+	iterator find(const TValue& val);
+
+	/**
+		@brief  Determines if the list contains a value
+	**/
+	bool contains(const TValue& val);
+
+	/**
+		@brief  Mark the value the iterator points at as erased
+
+		Performs in O(1) amortized constant time: O(1) for the tombstone, plus a compaction of O(n) once every
+		ratio * n erases
+		@param  pos - valid, dereferenceable iterator into this list
+		@retval iterator pointing at the live value following the erased one
+	**/
+	iterator erase(iterator pos);
+
+	/**
+		@brief  Unlink and free all tombstoned nodes in one pass
+
+		Performs in O(n) linear time, where n = the number of nodes including tombstoned ones
+		@retval size_t number of nodes freed
+	**/
+	size_type compact() noexcept;
+
+	/**
+		@brief Removes all values of the list
+	**/
+	void clear() noexcept;
+
+	iterator begin() noexcept;
+	iterator end() noexcept;
+
+	/**
+		@brief Get string representation of the list's live values suitable for display
+	**/
+	std::string toString() const;
+
+private:
+	struct Node
+	{
+		Node* next;
+		Node* prev;
+		bool erased;
+		TValue value;
+
+		explicit Node(const TValue& val)
+			: next(nullptr)
+			, prev(nullptr)
+			, erased(false)
+			, value(val)
+		{}
+	};
+
+	Node* head;
+	Node* tail;
+	// live values
+	size_type count;
+	// tombstoned nodes still linked
+	size_type erasedCount;
+	double ratio;
+
+	NodePool<Node> pool;
+
+	// Allocate a node holding val and link it BEFORE the given node, nullptr appends
+	void addBefore(Node* node, const TValue& val);
+	void unlink(Node* node) noexcept;
+	void destroy(Node* node) noexcept;
+	// Unlink and free tombstoned nodes at the ends, so head and tail are live
+	void trimEnds() noexcept;
+	// Unlink an end node, move it's value out and free the node
+	TValue removeEnd(Node* node);
+	// Skip tombstoned nodes, starting at node
+	static Node* live(Node* node) noexcept;
+};
+
+/**
+	@class  TombstoneList::iterator
+	@brief  Bidirectional iterator over the live values of a TombstoneList
+**/
+template<typename TValue>
+class TombstoneList<TValue>::iterator
+{
+public:
+	using iterator_category = std::bidirectional_iterator_tag;
+	using value_type = TValue;
+	using difference_type = std::ptrdiff_t;
+	using pointer = value_type*;
+	using reference = value_type&;
+
+	constexpr iterator() noexcept
+		: list(nullptr)
+		, current(nullptr)
+	{}
+
+	reference operator*() const noexcept
+	{
+		return current->value;
+	}
+
+	pointer operator->() const noexcept
+	{
+		return &current->value;
+	}
+
+	iterator& operator++() noexcept
+	{
+		current = live(current->next);
+		return *this;
+	}
+
+	iterator operator++(int) noexcept
+	{
+		auto it = *this;
+		++*this;
+		return it;
+	}
+
+	iterator& operator--() noexcept
+	{
+		// the tail is always live
+		if (current == nullptr)
+		{
+			current = list->tail;
+			return *this;
+		}
+		do
+		{
+			current = current->prev;
+		} while (current->erased);
+		return *this;
+	}
+
+	iterator operator--(int) noexcept
+	{
+		auto it = *this;
+		--*this;
+		return it;
+	}
+
+	bool operator==(const iterator& other) const noexcept
+	{
+		return current == other.current;
+	}
+
+	bool operator!=(const iterator& other) const noexcept
+	{
+		return current != other.current;
+	}
+
+private:
+	TombstoneList* list;
+	Node* current;
+
+	constexpr iterator(TombstoneList* list, Node* current) noexcept
+		: list(list)
+		, current(current)
+	{}
+
+	friend class TombstoneList<TValue>;
+};
+
+template<typename TValue>
+inline TombstoneList<TValue>::TombstoneList(double compactionRatio) noexcept
+	: head(nullptr)
+	, tail(nullptr)
+	, count(0)
+	, erasedCount(0)
+	, ratio(compactionRatio)
+	, pool()
+{}
+
+template<typename TValue>
+inline TombstoneList<TValue>::~TombstoneList()
+{
+	clear();
+}
+
+template<typename TValue>
+inline std::size_t TombstoneList<TValue>::size() const noexcept
+{
+	return count;
+}
+
+template<typename TValue>
+inline bool TombstoneList<TValue>::empty() const noexcept
+{
+	return count == 0;
+}
+
+template<typename TValue>
+inline std::size_t TombstoneList<TValue>::tombstones() const noexcept
+{
+	return erasedCount;
+}
+
+template<typename TValue>
+inline double TombstoneList<TValue>::compactionRatio() const noexcept
+{
+	return ratio;
+}
+
+template<typename TValue>
+inline void TombstoneList<TValue>::setCompactionRatio(double compactionRatio) noexcept
+{
+	ratio = compactionRatio;
+}
+
+template<typename TValue>
+inline void TombstoneList<TValue>::push_front(const TValue& val)
+{
+	addBefore(head, val);
+}
+
+template<typename TValue>
+inline void TombstoneList<TValue>::push_back(const TValue& val)
+{
+	addBefore(nullptr, val);
+}
+
+template<typename TValue>
+inline TValue& TombstoneList<TValue>::front()
+{
+	if (head == nullptr) throw std::runtime_error("list is empty");
+	return head->value;
+}
+
+template<typename TValue>
+inline TValue& TombstoneList<TValue>::back()
+{
+	if (tail == nullptr) throw std::runtime_error("list is empty");
+	return tail->value;
+}
+
+template<typename TValue>
+inline TValue TombstoneList<TValue>::pop_front()
+{
+	if (head == nullptr) throw std::runtime_error("cannot remove from empty list");
+	return removeEnd(head);
+}
+
+template<typename TValue>
+inline TValue TombstoneList<TValue>::pop_back()
+{
+	if (tail == nullptr) throw std::runtime_error("cannot remove from empty list");
+	return removeEnd(tail);
+}
+
+template<typename TValue>
+inline typename TombstoneList<TValue>::iterator TombstoneList<TValue>::find(const TValue& val)
+{
+	for (auto n = head; n != nullptr; n = n->next)
+	{
+		if (!n->erased && n->value == val)
+		{
+			return iterator(this, n);
+		}
+	}
+	return end();
+}
+
+template<typename TValue>
+inline bool TombstoneList<TValue>::contains(const TValue& val)
+{
+	return find(val) != end();
+}
+
+template<typename TValue>
+inline typename TombstoneList<TValue>::iterator TombstoneList<TValue>::erase(iterator pos)
+{
+	auto node = pos.current;
+	auto next = live(node->next);
+	node->erased = true;
+	count--;
+	erasedCount++;
+
+	if (node == head || node == tail)
+	{
+		trimEnds();
+	}
+	else if (static_cast<double>(erasedCount) > ratio * static_cast<double>(count + erasedCount))
+	{
+		compact();
+	}
+	return iterator(this, next);
+}
+
+template<typename TValue>
+inline std::size_t TombstoneList<TValue>::compact() noexcept
+{
+	size_type freed = 0;
+	auto n = head;
+	while (n != nullptr && erasedCount > 0)
+	{
+		auto next = n->next;
+		if (n->erased)
+		{
+			unlink(n);
+			destroy(n);
+			erasedCount--;
+			freed++;
+		}
+		n = next;
+	}
+	return freed;
+}
+
+template<typename TValue>
+inline void TombstoneList<TValue>::clear() noexcept
+{
+	if constexpr (!std::is_trivially_destructible_v<TValue>)
+	{
+		for (auto n = head; n != nullptr; n = n->next)
+		{
+			n->value.~TValue();
+		}
+	}
+	// every node is gone now, the pool's blocks can be dropped without visiting the nodes again
+	pool.release();
+	head = nullptr;
+	tail = nullptr;
+	count = 0;
+	erasedCount = 0;
+}
+
+template<typename TValue>
+inline typename TombstoneList<TValue>::iterator TombstoneList<TValue>::begin() noexcept
+{
+	return iterator(this, head);
+}
+
+template<typename TValue>
+inline typename TombstoneList<TValue>::iterator TombstoneList<TValue>::end() noexcept
+{
+	return iterator(this, nullptr);
+}
+
+template<typename TValue>
+inline std::string TombstoneList<TValue>::toString() const
+{
+	std::stringstream ss;
+	for (auto n = head; n != nullptr; n = live(n->next))
+	{
+		ss << '[' << n->value << ']';
+		if (n != tail)
+		{
+			ss << "<->";
+		}
+	}
+	return ss.str();
+}
+
+template<typename TValue>
+inline void TombstoneList<TValue>::addBefore(Node* node, const TValue& val)
+{
+	auto newNode = pool.create(val);
+	newNode->next = node;
+	newNode->prev = node == nullptr ? tail : node->prev;
+	if (newNode->prev != nullptr)
+	{
+		newNode->prev->next = newNode;
+	}
+	else
+	{
+		head = newNode;
+	}
+	if (node != nullptr)
+	{
+		node->prev = newNode;
+	}
+	else
+	{
+		tail = newNode;
+	}
+	count++;
+}
+
+template<typename TValue>
+inline void TombstoneList<TValue>::unlink(Node* node) noexcept
+{
+	if (node->prev != nullptr)
+	{
+		node->prev->next = node->next;
+	}
+	else
+	{
+		head = node->next;
+	}
+	if (node->next != nullptr)
+	{
+		node->next->prev = node->prev;
+	}
+	else
+	{
+		tail = node->prev;
+	}
+}
+
+template<typename TValue>
+inline void TombstoneList<TValue>::destroy(Node* node) noexcept
+{
+	pool.destroy(node);
+}
+
+template<typename TValue>
+inline void TombstoneList<TValue>::trimEnds() noexcept
+{
+	while (head != nullptr && head->erased)
+	{
+		auto node = head;
+		unlink(node);
+		destroy(node);
+		erasedCount--;
+	}
+	while (tail != nullptr && tail->erased)
+	{
+		auto node = tail;
+		unlink(node);
+		destroy(node);
+		erasedCount--;
+	}
+}
+
+template<typename TValue>
+inline TValue TombstoneList<TValue>::removeEnd(Node* node)
+{
+	auto val = std::move(node->value);
+	unlink(node);
+	destroy(node);
+	count--;
+	trimEnds();
+	return val;
+}
+
+template<typename TValue>
+inline typename TombstoneList<TValue>::Node* TombstoneList<TValue>::live(Node* node) noexcept
+{
+	while (node != nullptr && node->erased)
+	{
+		node = node->next;
+	}
+	return node;
+}
@@ -0,0 +1,649 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include "NodeCache.h"
+#include "NodeReclaimer.h"
+
+/**
+
+	@class   VersionedLinkedList
+	@brief   Multi-version FIFO list: readers iterate consistent snapshots while writers keep appending and popping
+
+	@details ~ Every change advances a global epoch. A node records the epoch that added it (begin) and the epoch that popped
+			   it (end); pop_front() only sets end, the node stays linked. A Snapshot takes the current epoch and sees exactly
+			   the nodes with begin <= epoch < end, walking the list without locks while writers go on. Because values are only
+			   appended at the back, a snapshot stops at the first node that is newer than it.
+			   Popped nodes are unlinked once no registered snapshot can see them anymore, and freed once no snapshot taken before
+			   the unlink is left, so a reader standing on an unlinked node can still step off it. Collection runs on a worker
+			   thread (ReclaimMode::Background) or inside push_back()/pop_front() (ReclaimMode::Incremental), or on demand
+			   with collect(). Writers are serialised by a mutex, readers only take a short registry lock when a snapshot
+			   starts and ends. Values are never moved out of a node, since a snapshot may still be reading it:
+			   pop_front() returns a copy. Nodes come from the NodeCache shared with LinkedList.
+			   All snapshots must be destroyed before the list.
+	@tparam  TValue - type of list's values
+
+**/
+template<typename TValue>
+class VersionedLinkedList
+{
+	struct Node;
+
+public:
+	using value_type = TValue;
+	using size_type = std::size_t;
+
+	class Snapshot;
+
+	/**
+		@brief Construct an empty list
+		@param mode - whether popped nodes are collected by a worker thread or by later writes
+	**/
+	explicit VersionedLinkedList(ReclaimMode mode = ReclaimMode::Background);
+
+	/**
+		@brief Stops the worker thread and frees every node, no snapshot may be alive
+	**/
+	~VersionedLinkedList();
+
+	VersionedLinkedList(const VersionedLinkedList&) = delete;
+	VersionedLinkedList& operator=(const VersionedLinkedList&) = delete;
+
+	/**
+		@brief  Returns number of values in the latest version of the list
+
+		Performs in O(1) constant time
+	**/
+	size_type size() const;
+
+	/**
+		@brief  Determines if the latest version of the list is empty
+
+		Performs in O(1) constant time
+	**/
+	bool empty() const;
+
+	/**
+		@brief Add a value to the back of the list
+
+		Performs in O(1) constant time, plus collection in ReclaimMode::Incremental
+		@param val - value to add
+	**/
+	void push_back(const TValue& val);
+	void push_back(TValue&& val);
+
+	/**
+		@brief  Removes the value at the beginning of the list and returns a copy of it
+
+		Performs in O(1) constant time, plus collection in ReclaimMode::Incremental.
+		Snapshots taken before the call still see the value.
+		@exception std::runtime_error if list is empty
+	**/
+	value_type pop_front();
+
+	/**
+		@brief  Take a consistent view of the current version of the list
+
+		Performs in O(log r) time, where r = the number of snapshots alive
+		@retval Snapshot iterable view, valid until destroyed
+	**/
+	Snapshot snapshot() const;
+
+	/**
+		@brief  Unlink popped nodes no snapshot can see, and free unlinked nodes no snapshot can stand on
+
+		Performs in O(k) time, where k = the number of nodes unlinked or freed
+		@retval size_t number of nodes freed
+	**/
+	std::size_t collect();
+
+	/**
+		@brief  Number of nodes still allocated, popped ones waiting for collection included
+	**/
+	std::size_t versions() const;
+
+	/**
+		@brief Get string representation of the latest version suitable for display
+	**/
+	std::string toString() const;
+
+private:
+	using Epoch = std::uint64_t;
+	static constexpr Epoch Forever = std::numeric_limits<Epoch>::max();
+
+	struct Node
+	{
+		std::atomic<Node*> next;
+		// epoch of the push, the node is visible to snapshots at or after it
+		Epoch begin;
+		// epoch of the pop, the node is invisible to snapshots at or after it; Forever while in the list
+		std::atomic<Epoch> end;
+		TValue value;
+
+		template<typename TArg>
+		Node(TArg&& val, Epoch begin)
+			: next(nullptr)
+			, begin(begin)
+			, end(Forever)
+			, value(std::forward<TArg>(val))
+		{}
+	};
+
+	// unlinked nodes waiting for the snapshots that may stand on them
+	struct Retired
+	{
+		Node* first;
+		Node* last;
+		// snapshots from this epoch on cannot reach the nodes
+		Epoch unlinked;
+	};
+
+	const ReclaimMode reclaimMode;
+
+	// serialises writers and collection
+	mutable std::mutex writeMutex;
+	std::atomic<Epoch> epoch;
+
+	// first linked node, popped or not; readers start here
+	std::atomic<Node*> head;
+	// last linked node, popped or not
+	Node* tail;
+	// first node not popped yet, nullptr if there is none
+	Node* live;
+	size_type count;
+	size_type allocated;
+
+	// unlinked chains, oldest first
+	std::deque<Retired> retired;
+
+	// epochs of alive snapshots and how many snapshots share each
+	mutable std::mutex readerMutex;
+	mutable std::map<Epoch, std::size_t> readers;
+
+	// collector thread for ReclaimMode::Background
+	mutable std::mutex workerMutex;
+	mutable std::condition_variable wake;
+	// set by writers and released snapshots, cleared by the collector before each pass
+	mutable std::atomic<bool> pendingWork;
+	bool stopping;
+	std::thread worker;
+
+	template<typename TArg>
+	void add(TArg&& val);
+
+	// Oldest epoch a snapshot may still read, the current epoch if there are no snapshots
+	Epoch oldestReader() const;
+
+	// collect() with writeMutex held
+	std::size_t collectLocked();
+
+	// Ask the collector thread for a pass
+	void signalCollector() const;
+
+	// Collector thread loop for ReclaimMode::Background
+	void run();
+
+	static void freeNode(Node* node) noexcept;
+
+	friend class Snapshot;
+};
+
+/**
+	@class  VersionedLinkedList::Snapshot
+	@brief  Consistent, read-only view of a VersionedLinkedList at one epoch; move-only, keeps it's nodes alive until destroyed
+**/
+template<typename TValue>
+class VersionedLinkedList<TValue>::Snapshot
+{
+public:
+	class const_iterator
+	{
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = TValue;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const value_type*;
+		using reference = const value_type&;
+
+		constexpr const_iterator() noexcept
+			: current(nullptr)
+			, epoch(0)
+		{}
+
+		reference operator*() const noexcept
+		{
+			return current->value;
+		}
+
+		pointer operator->() const noexcept
+		{
+			return &current->value;
+		}
+
+		const_iterator& operator++() noexcept
+		{
+			current = visibleFrom(current->next.load(std::memory_order_acquire), epoch);
+			return *this;
+		}
+
+		const_iterator operator++(int) noexcept
+		{
+			auto it = *this;
+			++*this;
+			return it;
+		}
+
+		bool operator==(const const_iterator& other) const noexcept
+		{
+			return current == other.current;
+		}
+
+		bool operator!=(const const_iterator& other) const noexcept
+		{
+			return !(*this == other);
+		}
+
+	private:
+		const Node* current;
+		Epoch epoch;
+
+		constexpr const_iterator(const Node* current, Epoch epoch) noexcept
+			: current(current)
+			, epoch(epoch)
+		{}
+
+		friend class Snapshot;
+	};
+
+	Snapshot(Snapshot&& other) noexcept
+		: list(std::exchange(other.list, nullptr))
+		, snapshotEpoch(other.snapshotEpoch)
+	{}
+
+	Snapshot& operator=(Snapshot&& other) noexcept
+	{
+		if (this != &other)
+		{
+			release();
+			list = std::exchange(other.list, nullptr);
+			snapshotEpoch = other.snapshotEpoch;
+		}
+		return *this;
+	}
+
+	Snapshot(const Snapshot&) = delete;
+	Snapshot& operator=(const Snapshot&) = delete;
+
+	~Snapshot()
+	{
+		release();
+	}
+
+	const_iterator begin() const noexcept
+	{
+		if (list == nullptr)
+		{
+			return end();
+		}
+		return const_iterator(visibleFrom(list->head.load(std::memory_order_acquire), snapshotEpoch), snapshotEpoch);
+	}
+
+	const_iterator end() const noexcept
+	{
+		return const_iterator(nullptr, snapshotEpoch);
+	}
+
+	/**
+		@brief  Number of values in the snapshot
+
+		Performs in O(n) linear time, where n = the number of nodes walked
+	**/
+	size_type size() const noexcept
+	{
+		size_type n = 0;
+		for (auto it = begin(); it != end(); ++it)
+		{
+			n++;
+		}
+		return n;
+	}
+
+	/**
+		@brief  Epoch the snapshot was taken at
+	**/
+	std::uint64_t epoch() const noexcept
+	{
+		return snapshotEpoch;
+	}
+
+private:
+	const VersionedLinkedList* list;
+	Epoch snapshotEpoch;
+
+	Snapshot(const VersionedLinkedList* list, Epoch epoch) noexcept
+		: list(list)
+		, snapshotEpoch(epoch)
+	{}
+
+	// First node from n on that the snapshot sees, nullptr past the snapshot's last node
+	static const Node* visibleFrom(const Node* n, Epoch epoch) noexcept
+	{
+		// popped nodes precede all live ones and newer nodes follow them, so skipping and stopping is enough
+		while (n != nullptr && n->end.load(std::memory_order_acquire) <= epoch)
+		{
+			n = n->next.load(std::memory_order_acquire);
+		}
+		return n != nullptr && n->begin <= epoch ? n : nullptr;
+	}
+
+	void release() noexcept
+	{
+		if (list == nullptr)
+		{
+			return;
+		}
+		{
+			std::lock_guard<std::mutex> lock(list->readerMutex);
+			auto reader = list->readers.find(snapshotEpoch);
+			if (--reader->second == 0)
+			{
+				list->readers.erase(reader);
+			}
+		}
+		list->signalCollector();
+		list = nullptr;
+	}
+
+	friend class VersionedLinkedList<TValue>;
+};
+
+template<typename TValue>
+inline VersionedLinkedList<TValue>::VersionedLinkedList(ReclaimMode mode)
+	: reclaimMode(mode)
+	, writeMutex()
+	, epoch(0)
+	, head(nullptr)
+	, tail(nullptr)
+	, live(nullptr)
+	, count(0)
+	, allocated(0)
+	, retired()
+	, readerMutex()
+	, readers()
+	, workerMutex()
+	, wake()
+	, pendingWork(false)
+	, stopping(false)
+	, worker()
+{
+	if (reclaimMode == ReclaimMode::Background)
+	{
+		worker = std::thread(&VersionedLinkedList::run, this);
+	}
+}
+
+template<typename TValue>
+inline VersionedLinkedList<TValue>::~VersionedLinkedList()
+{
+	if (worker.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(workerMutex);
+			stopping = true;
+		}
+		wake.notify_one();
+		worker.join();
+	}
+
+	for (auto& chain : retired)
+	{
+		auto n = chain.first;
+		while (n != nullptr)
+		{
+			auto next = n == chain.last ? nullptr : n->next.load(std::memory_order_relaxed);
+			freeNode(n);
+			n = next;
+		}
+	}
+
+	auto n = head.load(std::memory_order_relaxed);
+	while (n != nullptr)
+	{
+		auto next = n->next.load(std::memory_order_relaxed);
+		freeNode(n);
+		n = next;
+	}
+}
+
+template<typename TValue>
+inline std::size_t VersionedLinkedList<TValue>::size() const
+{
+	std::lock_guard<std::mutex> lock(writeMutex);
+	return count;
+}
+
+template<typename TValue>
+inline bool VersionedLinkedList<TValue>::empty() const
+{
+	std::lock_guard<std::mutex> lock(writeMutex);
+	return count == 0;
+}
+
+template<typename TValue>
+inline void VersionedLinkedList<TValue>::push_back(const TValue& val)
+{
+	add(val);
+}
+
+template<typename TValue>
+inline void VersionedLinkedList<TValue>::push_back(TValue&& val)
+{
+	add(std::move(val));
+}
+
+template<typename TValue>
+inline TValue VersionedLinkedList<TValue>::pop_front()
+{
+	std::unique_lock<std::mutex> lock(writeMutex);
+	if (live == nullptr) throw std::runtime_error("cannot remove from empty list");
+
+	auto node = live;
+	TValue val = node->value;
+	auto next = epoch.load(std::memory_order_relaxed) + 1;
+	node->end.store(next, std::memory_order_relaxed);
+	// publishes end: snapshots at this epoch or later no longer see the node
+	epoch.store(next, std::memory_order_release);
+	live = node->next.load(std::memory_order_relaxed);
+	count--;
+
+	if (reclaimMode == ReclaimMode::Incremental)
+	{
+		collectLocked();
+	}
+	else
+	{
+		lock.unlock();
+		signalCollector();
+	}
+	return val;
+}
+
+template<typename TValue>
+inline typename VersionedLinkedList<TValue>::Snapshot VersionedLinkedList<TValue>::snapshot() const
+{
+	std::lock_guard<std::mutex> lock(readerMutex);
+	// read under the registry lock, so a collection pass never misses a snapshot it has to wait for
+	auto at = epoch.load(std::memory_order_acquire);
+	readers[at]++;
+	return Snapshot(this, at);
+}
+
+template<typename TValue>
+inline std::size_t VersionedLinkedList<TValue>::collect()
+{
+	std::lock_guard<std::mutex> lock(writeMutex);
+	return collectLocked();
+}
+
+template<typename TValue>
+inline std::size_t VersionedLinkedList<TValue>::versions() const
+{
+	std::lock_guard<std::mutex> lock(writeMutex);
+	return allocated;
+}
+
+template<typename TValue>
+inline std::string VersionedLinkedList<TValue>::toString() const
+{
+	std::stringstream ss;
+	auto view = snapshot();
+	for (auto it = view.begin(); it != view.end(); )
+	{
+		ss << '[' << *it << ']';
+		if (++it != view.end())
+		{
+			ss << "<->";
+		}
+	}
+	return ss.str();
+}
+
+template<typename TValue>
+template<typename TArg>
+inline void VersionedLinkedList<TValue>::add(TArg&& val)
+{
+	std::lock_guard<std::mutex> lock(writeMutex);
+	auto next = epoch.load(std::memory_order_relaxed) + 1;
+
+	auto memory = NodeCache<Node>::allocate();
+	Node* node;
+	try
+	{
+		node = ::new (memory) Node(std::forward<TArg>(val), next);
+	}
+	catch (...)
+	{
+		NodeCache<Node>::deallocate(memory);
+		throw;
+	}
+
+	// link first, then advance the epoch: a snapshot that reads the new epoch also sees the link
+	(tail != nullptr ? tail->next : head).store(node, std::memory_order_release);
+	tail = node;
+	epoch.store(next, std::memory_order_release);
+	if (live == nullptr)
+	{
+		live = node;
+	}
+	count++;
+	allocated++;
+
+	if (reclaimMode == ReclaimMode::Incremental)
+	{
+		collectLocked();
+	}
+}
+
+template<typename TValue>
+inline VersionedLinkedList<TValue>::Epoch VersionedLinkedList<TValue>::oldestReader() const
+{
+	std::lock_guard<std::mutex> lock(readerMutex);
+	return readers.empty() ? epoch.load(std::memory_order_acquire) : readers.begin()->first;
+}
+
+template<typename TValue>
+inline std::size_t VersionedLinkedList<TValue>::collectLocked()
+{
+	// unlink the popped nodes at the front that no snapshot can see anymore; the tail stays, writers append to it
+	auto oldest = oldestReader();
+	auto firstUnlinked = head.load(std::memory_order_relaxed);
+	Node* lastUnlinked = nullptr;
+	for (auto n = firstUnlinked; n != live && n != tail && n->end.load(std::memory_order_relaxed) <= oldest;
+		n = n->next.load(std::memory_order_relaxed))
+	{
+		lastUnlinked = n;
+	}
+	if (lastUnlinked != nullptr)
+	{
+		head.store(lastUnlinked->next.load(std::memory_order_relaxed), std::memory_order_release);
+		// snapshots taken from the next epoch on start after the unlink
+		auto next = epoch.load(std::memory_order_relaxed) + 1;
+		epoch.store(next, std::memory_order_release);
+		retired.push_back(Retired{ firstUnlinked, lastUnlinked, next });
+	}
+
+	// free the chains no alive snapshot was taken before
+	std::size_t freed = 0;
+	oldest = oldestReader();
+	while (!retired.empty() && retired.front().unlinked <= oldest)
+	{
+		auto chain = retired.front();
+		retired.pop_front();
+		auto n = chain.first;
+		while (n != nullptr)
+		{
+			auto next = n == chain.last ? nullptr : n->next.load(std::memory_order_relaxed);
+			freeNode(n);
+			freed++;
+			n = next;
+		}
+	}
+	allocated -= freed;
+	return freed;
+}
+
+template<typename TValue>
+inline void VersionedLinkedList<TValue>::signalCollector() const
+{
+	if (reclaimMode != ReclaimMode::Background)
+	{
+		return;
+	}
+	// only the first signal after a pass wakes the collector, the rest cost one atomic exchange
+	if (!pendingWork.exchange(true))
+	{
+		{
+			std::lock_guard<std::mutex> lock(workerMutex);
+		}
+		wake.notify_one();
+	}
+}
+
+template<typename TValue>
+inline void VersionedLinkedList<TValue>::run()
+{
+	std::unique_lock<std::mutex> lock(workerMutex);
+	while (true)
+	{
+		wake.wait(lock, [this] { return stopping || pendingWork; });
+		if (stopping)
+		{
+			return;
+		}
+		pendingWork.store(false);
+
+		lock.unlock();
+		collect();
+		lock.lock();
+	}
+}
+
+template<typename TValue>
+inline void VersionedLinkedList<TValue>::freeNode(Node* node) noexcept
+{
+	node->~Node();
+	NodeCache<Node>::deallocate(node);
+}
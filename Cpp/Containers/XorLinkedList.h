@@ -0,0 +1,519 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include "NodePool.h"
+
+/**
+
+	@class   XorLinkedList
+	@brief   Doubly-linked list storing a single link word per node, prev XOR next
+
+	@details ~ Each node keeps the XOR of it's neighbours' addresses instead of two pointers, so a node of 8-byte values
+			   is 16 bytes instead of LinkedList's 24. Knowing one neighbour gives the other, so iterators carry two
+			   node pointers (the previous and the current node) and walk in both directions; end() holds the last
+			   node as it's previous node, so --end() is the last value. Nodes live in a NodePool owned by the list.
+			   Values can be added and removed at both ends in O(1); there is no insertion or removal in the middle.
+			   An iterator depends on the links of both of it's nodes, so changes at an end invalidate more than the
+			   removed value: push_front() invalidates iterators at the first value, push_back() invalidates end(),
+			   pop_front() invalidates iterators at the first two values, and pop_back() invalidates iterators at the
+			   last value and end(). Meant for memory-bound lists that are mostly traversed.
+	@tparam  TValue - type of list's values
+
+**/
+template<typename TValue>
+class XorLinkedList
+{
+public:
+	using value_type = TValue;
+	using reference = value_type&;
+	using const_reference = const value_type&;
+	using size_type = std::size_t;
+
+	class iterator;
+
+	/**
+		@brief Construct an empty list
+	**/
+	XorLinkedList() noexcept;
+	~XorLinkedList();
+
+	/**
+		@brief Construct a list holding copies of another list's values
+
+		Performs in O(n) linear time, where n = the number of values in the other list
+	**/
+	XorLinkedList(const XorLinkedList& other);
+
+	/**
+		@brief Construct a list taking over another list's nodes, the other list is left empty
+
+		Performs in O(1) constant time
+	**/
+	XorLinkedList(XorLinkedList&& other) noexcept;
+
+	XorLinkedList& operator=(const XorLinkedList& other);
+	XorLinkedList& operator=(XorLinkedList&& other) noexcept;
+
+	/**
+		@brief  Returns size of the list
+
+		Performs in O(1) constant time
+	**/
+	size_type size() const noexcept;
+
+	/**
+		@brief  Determines if the list is empty
+
+		Performs in O(1) constant time
+	**/
+	bool empty() const noexcept;
+
+	/**
+		@brief Add an element to the front of the list
+
+		Performs in O(1) constant time
+		@param val - value to add
+	**/
+	void push_front(const TValue& val);
+	void push_front(TValue&& val);
+
+	/**
+		@brief Add an element to the end of the list
+
+		Performs in O(1) constant time
+		@param val - value to add
+	**/
+	void push_back(const TValue& val);
+	void push_back(TValue&& val);
+
+	/**
+		@brief  Return the value at the beginning of the list
+		@exception std::runtime_error if list is empty
+	**/
+	reference front();
+	const_reference front() const;
+
+	/**
+		@brief  Return the value at the end of the list
+		@exception std::runtime_error if list is empty
+	**/
+	reference back();
+	const_reference back() const;
+
+	/**
+		@brief  Removes the value at the beginning of the list and returns it
+
+		Performs in O(1) constant time
+		@exception std::runtime_error if list is empty
+	**/
+	value_type pop_front();
+
+	/**
+		@brief  Removes the value at the end of the list and returns it
+
+		Performs in O(1) constant time
+		@exception std::runtime_error if list is empty
+	**/
+	value_type pop_back();
+
+	/**
+		@brief Removes all values of the list
+
+		Performs in O(n) linear time for values with destructors, otherwise the pool's blocks are freed directly
+	**/
+	void clear() noexcept;
+
+	iterator begin() noexcept;
+	iterator end() noexcept;
+
+	/**
+		@brief  Bytes of heap memory held by the list's nodes
+	**/
+	std::size_t memoryUsage() const noexcept;
+
+	/**
+		@brief Get string representation of the list's values suitable for display
+	**/
+	std::string toString() const;
+
+private:
+	struct Node
+	{
+		// address of the previous node XOR address of the next node, a missing neighbour counts as 0
+		std::uintptr_t link;
+		TValue value;
+
+		template<typename TArg>
+		explicit Node(TArg&& val)
+			: link(0)
+			, value(std::forward<TArg>(val))
+		{}
+	};
+
+	Node* head;
+	Node* tail;
+	size_type count;
+
+	NodePool<Node> pool;
+
+	static std::uintptr_t address(const Node* node) noexcept;
+	// The neighbour of node that is not other
+	static Node* neighbour(const Node* node, const Node* other) noexcept;
+
+	// Allocate a node holding val and make it the new first (atFront) or last node
+	template<typename TArg>
+	void add(TArg&& val, bool atFront);
+	// Unlink the first (atFront) or last node, move it's value out and free the node
+	TValue remove(bool atFront);
+};
+
+/**
+	@class  XorLinkedList::iterator
+	@brief  Bidirectional iterator over an XorLinkedList, holding the current node and the node before it
+**/
+template<typename TValue>
+class XorLinkedList<TValue>::iterator
+{
+public:
+	using iterator_category = std::bidirectional_iterator_tag;
+	using value_type = TValue;
+	using difference_type = std::ptrdiff_t;
+	using pointer = value_type*;
+	using reference = value_type&;
+
+	constexpr iterator() noexcept
+		: prev(nullptr)
+		, current(nullptr)
+	{}
+
+	reference operator*() const noexcept
+	{
+		return current->value;
+	}
+
+	pointer operator->() const noexcept
+	{
+		return &current->value;
+	}
+
+	iterator& operator++() noexcept
+	{
+		auto next = neighbour(current, prev);
+		prev = current;
+		current = next;
+		return *this;
+	}
+
+	iterator operator++(int) noexcept
+	{
+		auto it = *this;
+		++*this;
+		return it;
+	}
+
+	iterator& operator--() noexcept
+	{
+		auto before = neighbour(prev, current);
+		current = prev;
+		prev = before;
+		return *this;
+	}
+
+	iterator operator--(int) noexcept
+	{
+		auto it = *this;
+		--*this;
+		return it;
+	}
+
+	bool operator==(const iterator& other) const noexcept
+	{
+		return current == other.current && prev == other.prev;
+	}
+
+	bool operator!=(const iterator& other) const noexcept
+	{
+		return !(*this == other);
+	}
+
+private:
+	Node* prev;
+	Node* current;
+
+	constexpr iterator(Node* prev, Node* current) noexcept
+		: prev(prev)
+		, current(current)
+	{}
+
+	friend class XorLinkedList<TValue>;
+};
+
+template<typename TValue>
+inline XorLinkedList<TValue>::XorLinkedList() noexcept
+	: head(nullptr)
+	, tail(nullptr)
+	, count(0)
+	, pool()
+{}
+
+template<typename TValue>
+inline XorLinkedList<TValue>::~XorLinkedList()
+{
+	clear();
+}
+
+template<typename TValue>
+inline XorLinkedList<TValue>::XorLinkedList(const XorLinkedList& other)
+	: XorLinkedList()
+{
+	try
+	{
+		Node* prev = nullptr;
+		for (auto n = other.head; n != nullptr; )
+		{
+			push_back(n->value);
+			auto next = neighbour(n, prev);
+			prev = n;
+			n = next;
+		}
+	}
+	catch (...)
+	{
+		clear();
+		throw;
+	}
+}
+
+template<typename TValue>
+inline XorLinkedList<TValue>::XorLinkedList(XorLinkedList&& other) noexcept
+	: head(std::exchange(other.head, nullptr))
+	, tail(std::exchange(other.tail, nullptr))
+	, count(std::exchange(other.count, 0))
+	, pool(std::move(other.pool))
+{}
+
+template<typename TValue>
+inline XorLinkedList<TValue>& XorLinkedList<TValue>::operator=(const XorLinkedList& other)
+{
+	if (this != &other)
+	{
+		XorLinkedList copy(other);
+		*this = std::move(copy);
+	}
+	return *this;
+}
+
+template<typename TValue>
+inline XorLinkedList<TValue>& XorLinkedList<TValue>::operator=(XorLinkedList&& other) noexcept
+{
+	if (this != &other)
+	{
+		clear();
+		head = std::exchange(other.head, nullptr);
+		tail = std::exchange(other.tail, nullptr);
+		count = std::exchange(other.count, 0);
+		pool = std::move(other.pool);
+	}
+	return *this;
+}
+
+template<typename TValue>
+inline std::size_t XorLinkedList<TValue>::size() const noexcept
+{
+	return count;
+}
+
+template<typename TValue>
+inline bool XorLinkedList<TValue>::empty() const noexcept
+{
+	return head == nullptr;
+}
+
+template<typename TValue>
+inline void XorLinkedList<TValue>::push_front(const TValue& val)
+{
+	add(val, true);
+}
+
+template<typename TValue>
+inline void XorLinkedList<TValue>::push_front(TValue&& val)
+{
+	add(std::move(val), true);
+}
+
+template<typename TValue>
+inline void XorLinkedList<TValue>::push_back(const TValue& val)
+{
+	add(val, false);
+}
+
+template<typename TValue>
+inline void XorLinkedList<TValue>::push_back(TValue&& val)
+{
+	add(std::move(val), false);
+}
+
+template<typename TValue>
+inline TValue& XorLinkedList<TValue>::front()
+{
+	if (head == nullptr) throw std::runtime_error("list is empty");
+	return head->value;
+}
+
+template<typename TValue>
+inline const TValue& XorLinkedList<TValue>::front() const
+{
+	if (head == nullptr) throw std::runtime_error("list is empty");
+	return head->value;
+}
+
+template<typename TValue>
+inline TValue& XorLinkedList<TValue>::back()
+{
+	if (tail == nullptr) throw std::runtime_error("list is empty");
+	return tail->value;
+}
+
+template<typename TValue>
+inline const TValue& XorLinkedList<TValue>::back() const
+{
+	if (tail == nullptr) throw std::runtime_error("list is empty");
+	return tail->value;
+}
+
+template<typename TValue>
+inline TValue XorLinkedList<TValue>::pop_front()
+{
+	if (head == nullptr) throw std::runtime_error("cannot remove from empty list");
+	return remove(true);
+}
+
+template<typename TValue>
+inline TValue XorLinkedList<TValue>::pop_back()
+{
+	if (tail == nullptr) throw std::runtime_error("cannot remove from empty list");
+	return remove(false);
+}
+
+template<typename TValue>
+inline void XorLinkedList<TValue>::clear() noexcept
+{
+	if constexpr (!std::is_trivially_destructible_v<TValue>)
+	{
+		Node* prev = nullptr;
+		auto n = head;
+		while (n != nullptr)
+		{
+			auto next = neighbour(n, prev);
+			n->value.~TValue();
+			prev = n;
+			n = next;
+		}
+	}
+	// every node is gone now, the pool's blocks can be dropped without visiting the nodes again
+	pool.release();
+	head = nullptr;
+	tail = nullptr;
+	count = 0;
+}
+
+template<typename TValue>
+inline typename XorLinkedList<TValue>::iterator XorLinkedList<TValue>::begin() noexcept
+{
+	return iterator(nullptr, head);
+}
+
+template<typename TValue>
+inline typename XorLinkedList<TValue>::iterator XorLinkedList<TValue>::end() noexcept
+{
+	return iterator(tail, nullptr);
+}
+
+template<typename TValue>
+inline std::size_t XorLinkedList<TValue>::memoryUsage() const noexcept
+{
+	return pool.memoryUsage();
+}
+
+template<typename TValue>
+inline std::string XorLinkedList<TValue>::toString() const
+{
+	std::stringstream ss;
+	Node* prev = nullptr;
+	for (auto n = head; n != nullptr; )
+	{
+		ss << '[' << n->value << ']';
+		auto next = neighbour(n, prev);
+		if (next != nullptr)
+		{
+			ss << "<->";
+		}
+		prev = n;
+		n = next;
+	}
+	return ss.str();
+}
+
+template<typename TValue>
+inline std::uintptr_t XorLinkedList<TValue>::address(const Node* node) noexcept
+{
+	return reinterpret_cast<std::uintptr_t>(node);
+}
+
+template<typename TValue>
+inline XorLinkedList<TValue>::Node* XorLinkedList<TValue>::neighbour(const Node* node, const Node* other) noexcept
+{
+	return reinterpret_cast<Node*>(node->link ^ address(other));
+}
+
+template<typename TValue>
+template<typename TArg>
+inline void XorLinkedList<TValue>::add(TArg&& val, bool atFront)
+{
+	auto node = pool.create(std::forward<TArg>(val));
+	// the end node gains the new node as it's missing neighbour, so XOR it in
+	auto& end = atFront ? head : tail;
+	node->link = address(end);
+	if (end != nullptr)
+	{
+		end->link ^= address(node);
+	}
+	else
+	{
+		head = node;
+		tail = node;
+	}
+	end = node;
+	count++;
+}
+
+template<typename TValue>
+inline TValue XorLinkedList<TValue>::remove(bool atFront)
+{
+	auto& end = atFront ? head : tail;
+	auto node = end;
+	// an end node's only neighbour is it's whole link
+	auto inner = reinterpret_cast<Node*>(node->link);
+	if (inner != nullptr)
+	{
+		inner->link ^= address(node);
+		end = inner;
+	}
+	else
+	{
+		head = nullptr;
+		tail = nullptr;
+	}
+	count--;
+
+	auto val = std::move(node->value);
+	pool.destroy(node);
+	return val;
+}